@@ -0,0 +1,423 @@
+// 无模型的前后处理微基准：用合成帧和合成输出张量按实际形状驱动各阶段，
+// 报告每次操作的耗时、内存分配次数/字节和吞吐，可输出 JSON 便于跨提交对比。
+//
+//   ./bench [--filter 子串] [--min-time-ms 300] [--threads 1] [--json 路径|-] [--list]
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "data.h"
+#include "op.h"
+#include "yolo_decoder.h"
+#include "nms.h"
+#include "ctc_decoder.h"
+
+using namespace cv;
+using namespace std;
+
+// ---------------- 内存分配计数 ----------------
+// 统计 operator new（容器等）和 cv::Mat 缓冲区两类分配，只计次数和申请字节数
+namespace {
+atomic<uint64_t> allocCount{0};
+atomic<uint64_t> allocBytes{0};
+
+void countAlloc(size_t size) {
+    allocCount.fetch_add(1, memory_order_relaxed);
+    allocBytes.fetch_add(size, memory_order_relaxed);
+}
+
+// 委托给 OpenCV 默认分配器，只在新申请缓冲区时计数
+class CountingMatAllocator : public MatAllocator {
+public:
+    UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                       AccessFlag flags, UMatUsageFlags usageFlags) const override {
+        UMatData* u = Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+        if (u && !data) countAlloc(u->size);
+        return u;
+    }
+    bool allocate(UMatData* data, AccessFlag accessFlags, UMatUsageFlags usageFlags) const override {
+        return Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+    }
+    void deallocate(UMatData* data) const override {
+        Mat::getStdAllocator()->deallocate(data);
+    }
+};
+}
+
+void* operator new(size_t size) {
+    countAlloc(size);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+// 阻止编译器把结果未被使用的计算优化掉
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// ---------------- 基准定义与运行 ----------------
+struct Benchmark {
+    string name;
+    string shape;        // 输入形状说明
+    double items = 1;    // 每次操作处理的对象数（帧、ROI、文本行），用于计算吞吐
+    double bytes = 0;    // 每次操作读取的输入字节数，用于计算带宽
+    function<void()> body;
+};
+
+struct Result {
+    string name;
+    string shape;
+    uint64_t iterations = 0;
+    double nsPerOp = 0;      // 各轮的中位数
+    double nsPerOpMin = 0;
+    double allocsPerOp = 0;
+    double bytesPerOp = 0;
+    double itemsPerSec = 0;
+    double mbPerSec = 0;
+};
+
+double nowNs() {
+    return (double)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Result runBenchmark(const Benchmark& bench, double minTimeMs) {
+    // 预热：首轮调用完成缓冲区分配和缓存预热，不计入统计
+    bench.body();
+
+    // 估算每轮迭代次数，使单轮约 10 ms，降低计时开销的影响
+    double start = nowNs();
+    bench.body();
+    double single = max(1.0, nowNs() - start);
+    uint64_t perRound = max<uint64_t>(1, (uint64_t)(1e7 / single));
+
+    vector<double> rounds;
+    uint64_t iterations = 0;
+    uint64_t allocs0 = allocCount.load();
+    uint64_t bytes0 = allocBytes.load();
+    double begin = nowNs();
+    do {
+        double roundStart = nowNs();
+        for (uint64_t i = 0; i < perRound; ++i) {
+            bench.body();
+        }
+        rounds.push_back((nowNs() - roundStart) / perRound);
+        iterations += perRound;
+    } while ((nowNs() - begin) / 1e6 < minTimeMs || rounds.size() < 3);
+    uint64_t allocs = allocCount.load() - allocs0;
+    uint64_t bytes = allocBytes.load() - bytes0;
+
+    sort(rounds.begin(), rounds.end());
+    Result result;
+    result.name = bench.name;
+    result.shape = bench.shape;
+    result.iterations = iterations;
+    result.nsPerOp = rounds[rounds.size() / 2];
+    result.nsPerOpMin = rounds.front();
+    result.allocsPerOp = (double)allocs / iterations;
+    result.bytesPerOp = (double)bytes / iterations;
+    result.itemsPerSec = bench.items * 1e9 / result.nsPerOp;
+    result.mbPerSec = bench.bytes * 1e3 / result.nsPerOp;
+    return result;
+}
+
+void writeJson(ostream& out, const vector<Result>& results, int threads) {
+    out << "{\n  \"context\": {\"opencv\": \"" << CV_VERSION << "\", \"threads\": " << threads
+        << ", \"simd128\": " << (CV_SIMD128 ? "true" : "false") << "},\n  \"benchmarks\": [\n";
+    out << fixed << setprecision(2);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"shape\": \"" << r.shape << "\""
+            << ", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.nsPerOp
+            << ", \"ns_per_op_min\": " << r.nsPerOpMin
+            << ", \"allocs_per_op\": " << r.allocsPerOp
+            << ", \"bytes_allocated_per_op\": " << r.bytesPerOp
+            << ", \"items_per_sec\": " << r.itemsPerSec
+            << ", \"mb_per_sec\": " << r.mbPerSec << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// ---------------- 合成输入 ----------------
+Mat syntheticFrame(Size size, uint64 seed) {
+    Mat frame(size, CV_8UC3);
+    RNG rng(seed);
+    rng.fill(frame, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+    return frame;
+}
+
+// v8 检测头输出 [4+C, A]：大部分 anchor 置信度低于阈值，
+// 少数 anchor 聚集在几个目标附近，使 NMS 有实际的抑制工作量
+vector<float> syntheticYoloOutput(int numClasses, int numAnchors, int numObjects, int perObject) {
+    mt19937 rng(7);
+    uniform_real_distribution<float> low(0.0f, 0.2f);
+    uniform_real_distribution<float> high(0.3f, 0.95f);
+    uniform_real_distribution<float> pos(40.0f, 600.0f);
+    uniform_real_distribution<float> extent(10.0f, 60.0f);
+    uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+
+    int channels = 4 + numClasses;
+    vector<float> output((size_t)channels * numAnchors);
+    for (int a = 0; a < numAnchors; ++a) {
+        output[0 * numAnchors + a] = pos(rng);
+        output[1 * numAnchors + a] = pos(rng);
+        output[2 * numAnchors + a] = extent(rng);
+        output[3 * numAnchors + a] = extent(rng);
+        for (int c = 0; c < numClasses; ++c) {
+            output[(4 + c) * numAnchors + a] = low(rng);
+        }
+    }
+    for (int o = 0; o < numObjects; ++o) {
+        float cx = pos(rng), cy = pos(rng), w = extent(rng), h = extent(rng);
+        int cls = o % numClasses;
+        for (int k = 0; k < perObject; ++k) {
+            int a = (int)(rng() % numAnchors);
+            output[0 * numAnchors + a] = cx + jitter(rng);
+            output[1 * numAnchors + a] = cy + jitter(rng);
+            output[2 * numAnchors + a] = w + jitter(rng);
+            output[3 * numAnchors + a] = h + jitter(rng);
+            output[(4 + cls) * numAnchors + a] = high(rng);
+        }
+    }
+    return output;
+}
+
+// 字典：0 为 blank，数字位于中间位置，其余为占位字符
+vector<string> syntheticLabels(int numClasses) {
+    vector<string> labels(numClasses);
+    labels[0] = "blank";
+    for (int i = 1; i < numClasses; ++i) {
+        labels[i] = "c" + to_string(i);
+    }
+    for (int d = 0; d < 10; ++d) {
+        labels[16 + d] = string(1, char('0' + d));
+    }
+    return labels;
+}
+
+// [N, T, C] 的 softmax 输出：多数时间步 blank 占优，其余为某个数字
+vector<float> syntheticLogits(int batch, int timeSteps, int numClasses) {
+    mt19937 rng(11);
+    uniform_real_distribution<float> noise(0.0f, 0.1f / numClasses);
+    vector<float> probs((size_t)batch * timeSteps * numClasses);
+    for (size_t i = 0; i < probs.size(); ++i) {
+        probs[i] = noise(rng);
+    }
+    for (int b = 0; b < batch; ++b) {
+        for (int t = 0; t < timeSteps; ++t) {
+            int peak = rng() % 10 < 7 ? 0 : 16 + (int)(rng() % 10);
+            probs[((size_t)b * timeSteps + t) * numClasses + peak] = 0.9f;
+        }
+    }
+    return probs;
+}
+}
+
+int main(int argc, char* argv[]) {
+    string filter;
+    string jsonPath;
+    double minTimeMs = 300;
+    int threads = 1;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (arg == "--min-time-ms" && i + 1 < argc) minTimeMs = atof(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--list") list = true;
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--filter substr] [--min-time-ms ms] [--threads n] [--json path|-] [--list]" << endl;
+            return -1;
+        }
+    }
+    // 默认单线程，结果不受机器核数和负载影响，便于跨提交对比
+    setNumThreads(threads);
+    static CountingMatAllocator matAllocator;
+    Mat::setDefaultAllocator(&matAllocator);
+
+    vector<Benchmark> benches;
+
+    // ---------- YOLO 前处理 ----------
+    const Size inputSize(640, 640);
+    const Scalar padColor(114, 114, 114);
+    struct Source { const char* tag; Size size; };
+    const Source sources[] = {{"1080p", Size(1920, 1080)}, {"4k", Size(3840, 2160)}};
+    // 各基准闭包共享的状态，生命周期覆盖整个运行
+    static vector<Mat> frames;
+    static Mat letterboxOut, resizeBuffer;
+    static vector<float> blob(3 * (size_t)inputSize.area());
+    frames.reserve(2);
+    for (const Source& source : sources) {
+        frames.push_back(syntheticFrame(source.size, 1));
+        const Mat* frame = &frames.back();
+        string shape = to_string(source.size.width) + "x" + to_string(source.size.height) + " -> 640x640";
+        double bytes = (double)frame->total() * frame->elemSize();
+
+        benches.push_back({string("letterbox/") + source.tag, shape, 1, bytes, [frame, inputSize, padColor] {
+            data_utils::letterbox(*frame, letterboxOut, inputSize, padColor, false, false, true, 32);
+            doNotOptimize(letterboxOut.data);
+        }});
+        benches.push_back({string("yolo_preprocess/") + source.tag, shape, 1, bytes, [frame, inputSize, padColor] {
+            data_utils::letterboxToBlob(*frame, blob.data(), inputSize, padColor, resizeBuffer);
+            doNotOptimize(blob.data());
+        }});
+    }
+
+    // ---------- YOLO 后处理：解码 + NMS + 坐标映射，与 YOLOWrapper::postprocess 一致 ----------
+    const int numClasses = 3;
+    const int numAnchors = 8400;
+    static vector<float> yoloOutput = syntheticYoloOutput(numClasses, numAnchors, 5, 12);
+    static yolo_decoder::Params decodeParams =
+        yolo_decoder::resolveParams("v8", 4 + numClasses, numAnchors, 0.25f);
+    static vector<vector<Detection>> detections;
+    const string headShape = "[1," + to_string(4 + numClasses) + "," + to_string(numAnchors) + "]";
+    const double headBytes = (double)yoloOutput.size() * sizeof(float);
+    benches.push_back({"yolo_decode", headShape, 1, headBytes, [] {
+        detections.resize(1);
+        detections[0].clear();
+        yolo_decoder::decode(yoloOutput.data(), decodeParams, detections[0]);
+        doNotOptimize(detections[0].data());
+    }});
+    benches.push_back({"yolo_postprocess", headShape, 1, headBytes, [inputSize] {
+        nms_utils::Options options;
+        detections.resize(1);
+        detections[0].clear();
+        yolo_decoder::decode(yoloOutput.data(), decodeParams, detections[0]);
+        nms_utils::batchedNms(detections, options, 0);
+        for (Detection& det : detections[0]) {
+            data_utils::scaleCoords(det.box, inputSize, frames[0].size());
+        }
+        doNotOptimize(detections[0].data());
+    }});
+
+    // ---------- OCR 前处理：N 个计时区域裁切缩放到 [N,3,32,320] ----------
+    const int numRois = 6;
+    const int recH = 32, recW = 320;
+    const vector<float> mean = {0.5f, 0.5f, 0.5f};
+    const vector<float> scale = {1 / 0.5f, 1 / 0.5f, 1 / 0.5f};
+    static vector<Mat> crops;
+    for (int i = 0; i < numRois; ++i) {
+        crops.push_back(frames[0](Rect(1080 + i * 10, 180, 250, 220)));
+    }
+    static vector<Mat> resized(numRois), normalized(numRois);
+    static vector<float> recInput((size_t)numRois * 3 * recH * recW);
+    static PaddleOCR::CrnnResizeImg crnnResizeOp;
+    static PaddleOCR::Normalize normalizeOp;
+    static PaddleOCR::PermuteBatch permuteBatchOp;
+    static PaddleOCR::CrnnResizeNormPermute resizeNormPermuteOp;
+    const float whRatio = (float)recW / recH;
+    const string recShape = "[" + to_string(numRois) + ",3," + to_string(recH) + "," + to_string(recW) + "]";
+    const double cropBytes = numRois * 250.0 * 220.0 * 3;
+    const double resizedBytes = numRois * (double)recH * recW * 3;
+    for (int i = 0; i < numRois; ++i) {
+        crnnResizeOp.Run(crops[i], resized[i], whRatio, false, {3, recH, recW});
+    }
+
+    benches.push_back({"ocr_crnn_resize", recShape, (double)numRois, cropBytes, [whRatio, recH, recW] {
+        for (int i = 0; i < numRois; ++i) {
+            crnnResizeOp.Run(crops[i], resized[i], whRatio, false, {3, recH, recW});
+        }
+        doNotOptimize(resized[0].data);
+    }});
+    // Normalize 原地转换为浮点，每次先把缩放结果拷回工作区（拷贝开销计入）
+    benches.push_back({"ocr_normalize", recShape, (double)numRois, resizedBytes, [mean, scale] {
+        for (int i = 0; i < numRois; ++i) {
+            resized[i].copyTo(normalized[i]);
+            normalizeOp.Run(normalized[i], mean, scale, true);
+        }
+        doNotOptimize(normalized[0].data);
+    }});
+    benches.push_back({"ocr_permute_batch", recShape, (double)numRois, resizedBytes * sizeof(float), [] {
+        permuteBatchOp.Run(normalized, recInput.data());
+        doNotOptimize(recInput.data());
+    }});
+    benches.push_back({"ocr_preprocess", recShape, (double)numRois, cropBytes, [mean, scale, recH, recW] {
+        size_t imageSize = (size_t)3 * recH * recW;
+        for (int i = 0; i < numRois; ++i) {
+            resizeNormPermuteOp.Run(crops[i], recInput.data() + i * imageSize, recH, recW,
+                                    mean, scale, true, resizeBuffer);
+        }
+        doNotOptimize(recInput.data());
+    }});
+
+    // ---------- CTC 解码 [N,40,6625] ----------
+    const int timeSteps = 40;
+    const int dictSize = 6625;
+    static vector<float> logits = syntheticLogits(numRois, timeSteps, dictSize);
+    static CtcDecoder fullDecoder(syntheticLabels(dictSize));
+    static CtcDecoder digitDecoder(syntheticLabels(dictSize));
+    digitDecoder.restrictCharset("0123456789");
+    static vector<CtcResult> ctcResults;
+    const string ctcShape = "[" + to_string(numRois) + "," + to_string(timeSteps) + "," + to_string(dictSize) + "]";
+    const double logitBytes = (double)logits.size() * sizeof(float);
+    benches.push_back({"ctc_decode/full", ctcShape, (double)numRois, logitBytes, [timeSteps, dictSize] {
+        fullDecoder.decode(logits.data(), numRois, timeSteps, dictSize, ctcResults);
+        doNotOptimize(ctcResults.data());
+    }});
+    // 限定字符集只读取 11 列，带宽按实际读取量计算
+    benches.push_back({"ctc_decode/digits", ctcShape, (double)numRois, numRois * timeSteps * 11.0 * sizeof(float),
+                       [timeSteps, dictSize] {
+        digitDecoder.decode(logits.data(), numRois, timeSteps, dictSize, ctcResults);
+        doNotOptimize(ctcResults.data());
+    }});
+
+    // ---------- 运行 ----------
+    vector<Result> results;
+    cout << left << setw(26) << "benchmark" << setw(26) << "shape" << right
+         << setw(14) << "ns/op" << setw(12) << "allocs/op" << setw(14) << "bytes/op"
+         << setw(12) << "items/s" << setw(10) << "MB/s" << endl;
+    for (const Benchmark& bench : benches) {
+        if (!filter.empty() && bench.name.find(filter) == string::npos) continue;
+        if (list) {
+            cout << bench.name << "  " << bench.shape << endl;
+            continue;
+        }
+        Result r = runBenchmark(bench, minTimeMs);
+        cout << left << setw(26) << r.name << setw(26) << r.shape << right << fixed
+             << setprecision(0) << setw(14) << r.nsPerOp
+             << setprecision(1) << setw(12) << r.allocsPerOp
+             << setprecision(0) << setw(14) << r.bytesPerOp
+             << setw(12) << r.itemsPerSec << setw(10) << r.mbPerSec << endl;
+        results.push_back(r);
+    }
+
+    if (!jsonPath.empty() && !list) {
+        if (jsonPath == "-") {
+            writeJson(cout, results, threads);
+        } else {
+            ofstream out(jsonPath);
+            if (!out) {
+                cerr << "Error: Could not write " << jsonPath << endl;
+                return -1;
+            }
+            writeJson(out, results, threads);
+            cout << "结果已写入 " << jsonPath << endl;
+        }
+    }
+    Mat::setDefaultAllocator(nullptr);
+    return 0;
+}
@@ -0,0 +1,115 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+// 多生产者单消费者的无锁有界环形缓冲区（Vyukov 队列），每个槽位存放一条定长文本，
+// 入队不加锁也不分配内存，队满时立即返回 false
+template <size_t SlotSize>
+class MessageRing {
+public:
+    explicit MessageRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        slots_.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 超过槽位长度时 truncate 为 true 则截断，否则拒绝入队
+    bool tryPush(const char* data, size_t length, bool truncate) {
+        if (length > SlotSize) {
+            if (!truncate) return false;
+            length = SlotSize;
+        }
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // 队满
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        std::memcpy(slot->data, data, length);
+        slot->length = length;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅允许单个消费者调用
+    bool tryPop(std::string& out) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0) return false;  // 队空
+        out.assign(slot.data, slot.length);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        size_t length;
+        char data[SlotSize];
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    // 生产者和消费者的游标分处不同缓存行，避免伪共享（C++14 下 new 不保证 alignas 超对齐，改用填充）
+    char padding0_[64];
+    std::atomic<size_t> head_{0};
+    char padding1_[64];
+    std::atomic<size_t> tail_{0};
+};
+
+// 异步按行写出：生产者把整行写入无锁环形缓冲区，后台线程批量写入文件或标准输出，
+// 缓冲区满时丢弃并计数，生产者永不阻塞
+class AsyncWriter {
+public:
+    static const size_t kSlotSize = 512;
+
+    AsyncWriter() = default;
+    ~AsyncWriter();
+
+    // path 为空时写到标准输出；flushIntervalMs 为后台线程空闲时的轮询和刷新间隔
+    bool start(const std::string& path, size_t capacity, int flushIntervalMs);
+    void stop();
+    bool started() const { return started_; }
+
+    // 写入一行（不含换行符），truncate 为 false 时超长的行被丢弃
+    bool write(const std::string& line, bool truncate = true);
+
+    uint64_t written() const { return written_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    void sinkLoop();
+
+    std::unique_ptr<MessageRing<kSlotSize>> ring_;
+    FILE* file_ = nullptr;
+    bool ownsFile_ = false;
+    int flushIntervalMs_ = 100;
+    std::thread thread_;
+    std::atomic<bool> started_{false};
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<uint64_t> written_{0};   // 计数可能在其他线程读取
+    std::atomic<uint64_t> dropped_{0};
+};
+
+#endif // ASYNC_WRITER_H
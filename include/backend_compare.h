@@ -0,0 +1,55 @@
+#ifndef BACKEND_COMPARE_H
+#define BACKEND_COMPARE_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "yolo_wrapper.h"
+#include "ocr.h"
+
+// 推理后端对比：取视频前若干帧，用同一批输入依次驱动各候选后端，
+// 报告每个后端的单次推理延迟和与第一个后端结果的一致率
+namespace backend_compare {
+    struct Config {
+        int frames = 50;   // 参与计时的帧数
+        int warmup = 5;    // 每个后端开始计时前的预热帧数
+        std::vector<std::string> yoloBackends;  // 为空时不对比
+        std::vector<std::string> ocrBackends;
+    };
+
+    // 两组检测结果的差异统计，reference 为基准（如 FP32 模型）
+    struct DetectionDelta {
+        size_t referenceBoxes = 0;
+        size_t candidateBoxes = 0;
+        size_t matched = 0;
+        double iouSum = 0;
+        double scoreDeltaSum = 0;           // 匹配框置信度差的绝对值之和
+        std::vector<size_t> classReference; // 按类别统计的基准框数 / 匹配数
+        std::vector<size_t> classMatched;
+
+        double recall() const { return referenceBoxes ? (double)matched / referenceBoxes : 1.0; }
+        double precision() const { return candidateBoxes ? (double)matched / candidateBoxes : 1.0; }
+        // 一致率：匹配数 * 2 / 两边框总数，两边都没有框时为 1
+        double agreement() const {
+            size_t total = referenceBoxes + candidateBoxes;
+            return total ? 2.0 * matched / total : 1.0;
+        }
+        double meanIou() const { return matched ? iouSum / matched : 0; }
+        double meanScoreDelta() const { return matched ? scoreDeltaSum / matched : 0; }
+    };
+
+    // 累加一张图像的对比结果：基准框按置信度从高到低，贪心匹配同类别且 IoU >= iouThreshold 的框
+    void compareDetections(const std::vector<Detection>& reference,
+                           const std::vector<Detection>& candidate,
+                           DetectionDelta& delta, float iouThreshold = 0.5f);
+
+    // lightROIs / timerROIs 为空时使用整帧；返回 0 表示所有后端都运行成功
+    int run(const Config& config,
+            const std::string& videoSource,
+            const YOLOWrapper::Config& yoloConfig,
+            const OCRWrapper::Config& ocrConfig,
+            const std::vector<cv::Rect>& lightROIs,
+            const std::vector<cv::Rect>& timerROIs);
+}
+
+#endif // BACKEND_COMPARE_H
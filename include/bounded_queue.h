@@ -0,0 +1,120 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// 有界阻塞队列：队满时 push 阻塞（背压），队空时 pop 阻塞，close 后唤醒所有等待者
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    // 返回 false 表示队列已关闭
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (queue_.size() >= capacity_) {
+            auto start = std::chrono::steady_clock::now();
+            notFull_.wait(lock, [this] { return queue_.size() < capacity_ || closed_; });
+            blockedUs_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        if (closed_) return false;
+        queue_.push_back(std::move(item));
+        occupancySum_ += queue_.size();
+        ++pushCount_;
+        peak_ = std::max(peak_, queue_.size());
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // 阻塞直到队列有空位，返回 false 表示队列已关闭
+    bool waitForSpace() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return queue_.size() < capacity_ || closed_; });
+        return !closed_;
+    }
+
+    // 返回 false 表示队列已关闭且已取空
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+        if (queue_.empty()) return false;
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    // 非阻塞入队，队满或已关闭时立即返回 false
+    bool tryPush(T item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || queue_.size() >= capacity_) return false;
+        queue_.push_back(std::move(item));
+        occupancySum_ += queue_.size();
+        ++pushCount_;
+        peak_ = std::max(peak_, queue_.size());
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // 非阻塞出队，队空时立即返回 false
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) return false;
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // 每次入队时采样得到的平均占用
+    double averageOccupancy() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pushCount_ ? double(occupancySum_) / pushCount_ : 0.0;
+    }
+
+    size_t peakOccupancy() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_;
+    }
+
+    // 生产者因队满而阻塞的累计时间（毫秒）
+    double blockedMs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return blockedUs_ / 1000.0;
+    }
+
+private:
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<T> queue_;
+    bool closed_ = false;
+
+    uint64_t occupancySum_ = 0;
+    uint64_t pushCount_ = 0;
+    size_t peak_ = 0;
+    int64_t blockedUs_ = 0;
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// 单条识别结果：文本及其平均置信度（未识别出字符时为空串、置信度 0）
+struct CtcResult {
+    std::string text;
+    float score = 0.0f;
+};
+
+// CTC 贪心解码：每个时间步一次融合的 argmax（同时求出最大值和下标），
+// 可限定只评估 blank 与指定字符所在的列，不依赖推理库，可单独测试和基准测试
+class CtcDecoder {
+public:
+    CtcDecoder() = default;
+
+    // labels[0] 为 blank
+    explicit CtcDecoder(const std::vector<std::string>& labels);
+
+    // 限定字符集（如 "0123456789"），为空则评估全部类别；字典中不存在的字符被忽略
+    void restrictCharset(const std::string& charset);
+
+    bool restricted() const { return !columns_.empty(); }
+
+    // 解码 [batchSize, timeSteps, numClasses] 的概率输出
+    void decode(const float* probs, int batchSize, int timeSteps, int numClasses,
+                std::vector<CtcResult>& results) const;
+
+    // 单行 argmax，返回下标并通过 maxValue 输出最大值
+    static int argmax(const float* row, int length, float& maxValue);
+
+private:
+    std::vector<std::string> labels_;
+    std::vector<int> columns_;  // 限定模式下参与评估的列（含 blank）
+};
@@ -8,7 +8,7 @@
 #include <codecvt>
 #include <ctime>
 #include <iostream>
-#include "yolo_wrapper.h"
+#include "detection.h"
 
 namespace data_utils {
     // 计算向量元素乘积
@@ -33,6 +33,13 @@ namespace data_utils {
                   bool scaleUp,
                   int stride);
 
+    // 融合 letterbox：BGR->RGB、缩放、填充、归一化到 [0,1]、HWC->CHW 一次完成，
+    // 直接写入 blob（3 * newShape.area() 个 float）。resizeBuffer 由调用方持有以复用内存
+    void letterboxToBlob(const cv::Mat &image, float *blob,
+                         const cv::Size &newShape,
+                         const cv::Scalar &color,
+                         cv::Mat &resizeBuffer);
+
     // 坐标缩放
     void scaleCoords(cv::Rect &coords, const cv::Size &imageShape, const cv::Size &imageOriginalShape);
 
@@ -0,0 +1,8 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+
+struct Detection {
+    cv::Rect box;
+    float confidence;
+    int classId;
+};
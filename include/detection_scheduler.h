@@ -0,0 +1,75 @@
+#ifndef DETECTION_SCHEDULER_H
+#define DETECTION_SCHEDULER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "detection.h"
+
+// 关键帧检测调度：信号灯灯箱基本静止，每隔 N 帧或触发条件满足时才运行 YOLO，
+// 关键帧之间用 IoU 匹配 + alpha-beta 滤波跟踪检测框，并在框内做低成本的颜色校验，
+// N 根据最近关键帧结果的稳定程度自适应调整
+class DetectionScheduler {
+public:
+    struct Config {
+        bool enable = false;
+        int minInterval = 1;         // 关键帧最短间隔（帧）
+        int maxInterval = 15;        // 关键帧最长间隔（帧）
+        float confTrigger = 0.4f;    // 任一跟踪框置信度低于该值时按最短间隔检测
+        float motionTrigger = 8.0f;  // ROI 缩略图平均灰度差超过该值时立即检测
+        float stableIou = 0.7f;      // 关键帧检测框与跟踪框 IoU 不低于该值视为稳定
+        float alpha = 0.5f;          // 位置滤波系数
+        float beta = 0.1f;           // 速度滤波系数
+        bool colorCheck = true;      // 非关键帧校验框内亮灯颜色
+        int greenClassId = 0;
+        int redClassId = 1;
+        int yellowClassId = 2;
+    };
+
+    DetectionScheduler() = default;
+    explicit DetectionScheduler(const Config& config) : config_(config), interval_(config.minInterval) {}
+
+    // 本帧是否需要运行检测器
+    bool shouldDetect(const cv::Mat& frame);
+
+    // 非关键帧：输出跟踪预测的检测框，颜色校验失败时返回 false，调用方应改为运行检测器
+    bool track(const cv::Mat& frame, std::vector<Detection>& detections);
+
+    // 关键帧：提交检测结果，更新跟踪器并调整关键帧间隔
+    void update(const cv::Mat& frame, const std::vector<Detection>& detections);
+
+    int interval() const { return interval_; }
+    uint64_t keyframes() const { return keyframes_; }
+    uint64_t trackedFrames() const { return trackedFrames_; }
+
+private:
+    struct Track {
+        Detection detection;
+        cv::Point2f center;
+        cv::Point2f velocity;  // 每帧位移
+        cv::Size2f size;
+        int litColor = -1;     // 关键帧时框内亮灯颜色对应的类别，-1 表示未亮
+    };
+
+    // 框内亮灯颜色对应的类别，未检测到亮灯返回 -1
+    int dominantColor(const cv::Mat& frame, const cv::Rect& box);
+    void computeThumbnail(const cv::Mat& frame, cv::Mat& thumbnail);
+    cv::Rect predictBox(const Track& track, int frames) const;
+
+    Config config_;
+    std::vector<Track> tracks_;
+    std::atomic<int> interval_{1};            // 可能在其他线程读取
+    int framesSinceKeyframe_ = 0;
+    bool hasKeyframe_ = false;
+
+    cv::Mat keyThumbnail_;
+    cv::Mat thumbnail_;
+    cv::Mat hsv_;
+    cv::Mat diff_;
+
+    std::atomic<uint64_t> keyframes_{0};      // 计数可能在其他线程读取
+    std::atomic<uint64_t> trackedFrames_{0};
+};
+
+#endif // DETECTION_SCHEDULER_H
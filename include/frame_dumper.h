@@ -0,0 +1,58 @@
+#ifndef FRAME_DUMPER_H
+#define FRAME_DUMPER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "bounded_queue.h"
+
+// 调试帧转储：按采样间隔、状态变化或异常选择要保存的帧，
+// 由后台线程编码写盘；队列满时直接丢弃并计数，不阻塞处理流水线
+class FrameDumper {
+public:
+    struct Config {
+        bool enable = false;
+        std::string outputDir = "../results/output_frames";
+        int sampleInterval = 0;     // 每隔 N 帧保存一帧（1 为每帧保存），0 表示不按间隔采样
+        bool onTransition = true;   // 状态或信号灯颜色变化时保存
+        bool onAnomaly = false;     // 处于异常状态时保存
+        int queueCapacity = 8;      // 待编码帧队列容量
+        int jpegQuality = 90;
+    };
+
+    explicit FrameDumper(const Config& config);
+    ~FrameDumper();
+
+    // 该帧是否需要保存
+    bool wanted(int64_t index, bool transition, bool anomaly) const;
+
+    // 提交一帧，非阻塞；frame 与调用方共享数据，提交后调用方不应再修改。队列满时返回 false
+    bool submit(const cv::Mat& frame, const std::string& fileName);
+
+    // 等待队列中的帧全部写完并停止后台线程
+    void stop();
+
+    uint64_t written() const { return written_; }
+    uint64_t dropped() const { return dropped_; }
+    uint64_t failed() const { return failed_; }
+
+private:
+    struct Job {
+        cv::Mat frame;
+        std::string path;
+    };
+
+    void writeLoop();
+
+    Config config_;
+    BoundedQueue<Job> queue_;
+    std::thread thread_;
+
+    std::atomic<uint64_t> written_{0};   // 计数可能在其他线程读取
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> failed_{0};
+};
+
+#endif // FRAME_DUMPER_H
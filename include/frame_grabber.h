@@ -0,0 +1,57 @@
+#ifndef FRAME_GRABBER_H
+#define FRAME_GRABBER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 实时流采集：后台线程持续读取到预分配的环形缓冲区，消费方总是取最新一帧，
+// 处理不及时的帧直接丢弃并计数，端到端延迟不会随积压无限增长
+class FrameGrabber {
+public:
+    struct Frame {
+        cv::Mat frame;
+        int64_t sequence = 0;   // 自采集开始的帧序号，跳号即为被丢弃的帧
+        double posMsec = 0;     // CAP_PROP_POS_MSEC
+        std::chrono::steady_clock::time_point grabTime;
+    };
+
+    FrameGrabber(cv::VideoCapture& cap, int ringSize);
+    ~FrameGrabber();
+
+    void start();
+    void stop();
+
+    // 阻塞等待比上次取走的更新的一帧，采集结束且没有新帧时返回 false
+    bool read(Frame& out);
+
+    uint64_t grabbed() const { return grabbed_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    void grabLoop();
+
+    cv::VideoCapture& cap_;
+    std::vector<cv::Mat> ring_;
+    std::vector<Frame> slots_;     // 与 ring_ 对应的帧信息
+
+    std::mutex mutex_;
+    std::condition_variable frameReady_;
+    int latest_ = -1;              // 最新一帧所在槽位
+    int64_t latestSequence_ = 0;
+    int64_t consumedSequence_ = 0;
+    bool finished_ = false;
+
+    std::mutex joinMutex_;
+    std::thread thread_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<uint64_t> grabbed_{0};    // 计数可能在其他线程读取
+    std::atomic<uint64_t> dropped_{0};
+};
+
+#endif // FRAME_GRABBER_H
@@ -0,0 +1,41 @@
+#ifndef INFERENCE_BACKEND_H
+#define INFERENCE_BACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 推理后端：隔离具体推理库，YOLOWrapper / OCRWrapper 只负责前后处理，
+// 后端只做 NCHW 浮点张量进、第一个输出张量出。输入缓冲区由后端持有，
+// 前处理直接写入，形状不变时反复使用同一块内存
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    virtual std::string name() const = 0;
+
+    // 模型是否加载成功；加载失败但未抛出异常的后端（如 Paddle）在此返回 false，run 总是失败
+    virtual bool loaded() const { return true; }
+
+    // 模型输入形状 [N, C, H, W]，动态维度为 -1
+    virtual std::vector<int64_t> inputShape() const = 0;
+
+    // 按输入形状准备输入缓冲区，返回可写入的指针（至少 N*C*H*W 个 float）
+    virtual float* prepareInput(const std::vector<int64_t>& shape) = 0;
+
+    // 以最近一次 prepareInput 的缓冲区为输入执行推理，返回第一个输出的数据并写出其形状，
+    // 失败时返回空指针。返回的数据在下一次 prepareInput / run 之前有效
+    virtual const float* run(std::vector<int64_t>& outputShape) = 0;
+};
+
+// 按名称创建推理后端，未知名称返回空指针：
+//   onnxruntime / opencv_dnn：modelPath 为 ONNX 文件
+//   paddle / paddle_openvino：modelPath 为 Paddle 模型目录
+// inputShape 为模型输入形状，供不能从模型读取形状的后端使用（动态维度为 -1）
+std::unique_ptr<InferenceBackend> createInferenceBackend(const std::string& name,
+                                                         const std::string& modelPath,
+                                                         int numThreads,
+                                                         const std::vector<int64_t>& inputShape);
+
+#endif // INFERENCE_BACKEND_H
@@ -0,0 +1,60 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <sstream>
+#include <string>
+#include "async_writer.h"
+
+enum class LogLevel {
+    Debug = 0,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+// 分级日志：低于当前级别的日志在格式化之前即被过滤；
+// 启动后经无锁环形缓冲区由后台线程写出，未启动时直接同步写到标准输出
+class Logger {
+public:
+    struct Config {
+        std::string level = "info";   // debug / info / warn / error / off
+        std::string file;             // 为空则写到标准输出
+        int ringCapacity = 4096;      // 缓冲的日志行数，满时丢弃
+        int flushIntervalMs = 50;
+    };
+
+    static Logger& instance();
+
+    bool start(const Config& config);
+    void stop();
+
+    bool enabled(LogLevel level) const { return level >= level_; }
+    void write(LogLevel level, const std::string& message);
+
+    uint64_t dropped() const { return writer_.dropped(); }
+
+    static LogLevel parseLevel(const std::string& name);
+
+private:
+    Logger() = default;
+
+    LogLevel level_ = LogLevel::Info;
+    AsyncWriter writer_;
+};
+
+#define LOG_AT(level, expr)                                   \
+    do {                                                      \
+        if (Logger::instance().enabled(level)) {              \
+            std::ostringstream logStream_;                    \
+            logStream_ << expr;                               \
+            Logger::instance().write(level, logStream_.str()); \
+        }                                                     \
+    } while (0)
+
+#define LOG_DEBUG(expr) LOG_AT(LogLevel::Debug, expr)
+#define LOG_INFO(expr) LOG_AT(LogLevel::Info, expr)
+#define LOG_WARN(expr) LOG_AT(LogLevel::Warn, expr)
+#define LOG_ERROR(expr) LOG_AT(LogLevel::Error, expr)
+
+#endif // LOGGER_H
@@ -0,0 +1,138 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 对数-线性分桶的延迟直方图（HDR 风格）：每个 2 的幂区间再等分为 8 个子桶，
+// 相对误差约 12.5%，覆盖 1us ~ 数十秒。每个写入线程有自己的分片，记录时只写本线程分片
+// （单写者，无原子读-改-写），多路模式下多个采集线程同时记录 "decode" 也不会争用缓存行；
+// 读取时合并所有分片
+class LatencyHistogram {
+public:
+    static const int kSubBuckets = 8;
+    static const int kSubBits = 3;
+    static const int kExponents = 37;
+    static const int kBuckets = kExponents * kSubBuckets;
+
+    LatencyHistogram();
+
+    void record(int64_t us);
+
+    uint64_t count() const;
+    double sumSeconds() const;
+    // 分位数（微秒），取所在子桶的中点
+    double quantileUs(double q) const;
+
+private:
+    // 单个线程的计数；只由所属线程写入，原子变量仅保证读取方看到完整的值
+    struct Shard {
+        std::atomic<uint64_t> buckets[kBuckets] = {};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sumUs{0};
+    };
+
+    static int bucketOf(uint64_t us);
+    static double bucketMidUs(int bucket);
+    // 当前线程的分片，首次记录时创建
+    Shard& localShard();
+
+    const uint64_t id_;  // 线程本地分片缓存的键，不复用地址以免误命中已销毁的直方图
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// 作用域计时：析构时把经过的时间记入直方图，histogram 为空时不计时
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram* histogram)
+        : histogram_(histogram),
+          start_(histogram ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()) {}
+    ~ScopedTimer() {
+        if (histogram_) {
+            histogram_->record(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_).count());
+        }
+    }
+
+private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 指标注册表：各阶段延迟直方图，以及按需采样的计数器/仪表（队列深度、丢帧数等），
+// 导出为 Prometheus 文本格式，可通过本地 HTTP 端口或定期写文件提供
+class Metrics {
+public:
+    struct Config {
+        bool enable = false;
+        std::string bindAddress = "127.0.0.1";
+        int httpPort = 9464;          // 0 表示不开启 HTTP
+        std::string file;             // 为空则不写文件
+        int fileIntervalMs = 5000;
+    };
+
+    static Metrics& instance();
+
+    void start(const Config& config);
+    void stop();
+    bool enabled() const { return enabled_; }
+
+    // 阶段延迟直方图，同名返回同一个；未启用时返回空指针。返回的指针在进程生命周期内有效
+    LatencyHistogram* histogram(const std::string& stage);
+    // 带缓存的查找：cache 为空时按 histogram() 查找，只有查到后才写入缓存，
+    // 因此在 start() 之前执行的调用不会把空指针永久缓存下来
+    LatencyHistogram* histogram(std::atomic<LatencyHistogram*>& cache, const char* stage);
+
+    // 注册采样回调，type 为 "gauge" 或 "counter"，返回的 id 用于注销
+    int addCallback(const std::string& name, const std::string& labels,
+                    const std::string& type, std::function<double()> sample);
+    void removeCallback(int id);
+
+    // Prometheus 文本格式
+    std::string render();
+
+private:
+    Metrics() = default;
+    ~Metrics();
+
+    struct Callback {
+        std::string name;
+        std::string labels;
+        std::string type;
+        std::function<double()> sample;
+    };
+
+    void serveLoop();
+    void writeFile(const std::string& text);
+
+    Config config_;
+    std::atomic<bool> enabled_{false};
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+    std::map<int, Callback> callbacks_;
+    int nextCallbackId_ = 0;
+
+    int listenFd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> stopRequested_{false};
+};
+
+#define METRICS_CONCAT_(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_(a, b)
+
+// 在当前作用域计时，stage 为阶段名；指标启用后首次执行时查找直方图并缓存
+#define METRICS_SCOPE(stage)                                                                   \
+    static std::atomic<LatencyHistogram*> METRICS_CONCAT(metricsHistogram_, __LINE__){nullptr}; \
+    ScopedTimer METRICS_CONCAT(metricsTimer_, __LINE__)(                                       \
+        Metrics::instance().histogram(METRICS_CONCAT(metricsHistogram_, __LINE__), stage))
+
+#endif // METRICS_H
@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include "detection.h"
+
+namespace nms_utils {
+    struct Options {
+        float iouThreshold = 0.45f;
+        bool classAgnostic = false;  // true 时不同类别的框也互相抑制
+        int topK = 1000;             // 进入 NMS 前按置信度保留的候选数（<=0 不限制）
+        int maxDetections = 100;     // 每张图像最多输出的框数（<=0 不限制）
+    };
+
+    // 两个框的 IoU
+    float iou(const cv::Rect& a, const cv::Rect& b);
+
+    // 原地 NMS：先截取置信度最高的 topK 个候选并降序排序，再贪心抑制，
+    // 保留的框按置信度降序留在 detections 中，达到 maxDetections 后提前结束
+    void nms(std::vector<Detection>& detections, const Options& options);
+
+    // 批量 NMS：从 first 开始对每张图像的候选框分别执行 nms
+    void batchedNms(std::vector<std::vector<Detection>>& batch, const Options& options, size_t first = 0);
+}
@@ -3,19 +3,53 @@
 
 #include <opencv2/opencv.hpp>
 #include <string>
-#include <paddle_inference_api.h>
+#include <deque>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include "op.h"
+#include "ctc_decoder.h"
+#include "inference_backend.h"
+#include "stub_backend.h"
 
 class OCRWrapper {
 public:
     struct Config {
         std::string modelPath;
         int intraOpNumThreads = 4;  // 默认线程数
-        bool useMkldnn = false;
+        bool useMkldnn = true;      // paddle 后端是否使用 MKLDNN
         int recBatchNum = 6;
         int recImgH = 32;
         int recImgW = 320;
         std::string dictPath;
+        std::string charset;  // 限定识别字符集（如 "0123456789"），为空则使用完整字典
+
+        // ROI 变化检测缓存：画面基本不变时直接复用上一次的识别结果
+        bool cacheEnable = false;
+        int cacheTolerance = 12;   // 缩略图逐像素最大灰度差不超过该值视为未变化
+        int cacheThumbSize = 16;   // 缩略图边长
+        int cacheCapacity = 8;     // 缓存条目数
+
+        // 形状分桶：输入宽度和批大小向上补齐到固定档位，避免每次推理都产生新形状
+        // 导致 MKLDNN 重新创建算子，启动时对所有档位预热
+        bool bucketEnable = false;
+        std::vector<int> bucketWidths = {320, 480, 640};
+        std::vector<int> bucketBatchSizes = {1, 2, 4, 6};
+        bool bucketWarmup = true;
+
+        // 推理后端：paddle / paddle_openvino（modelPath 目录）、onnxruntime / opencv_dnn（onnxModelPath，
+        // 由 paddle2onnx 导出）、stub（不加载模型，输出 stub.text）
+        std::string backend = "paddle";
+        std::string onnxModelPath;
+        StubBackend::Config stub;
+
+        // paddle / paddle_openvino 后端的计算精度：fp32 / bf16 / int8。int8 加载 int8ModelDir 中
+        // PaddleSlim 量化后的模型，精度报告中与 FP32 的识别一致率不低于 int8MinAgreement 时才启用，
+        // 否则回退到 modelPath 的 fp32 模型
+        std::string precision = "fp32";
+        std::string int8ModelDir;
+        std::string int8ReportPath;  // 为空时为 int8ModelDir + ".report.yaml"
+        double int8MinAgreement = 0.99;
     };
 
     OCRWrapper(const Config& config);
@@ -23,27 +57,77 @@ public:
 
     std::vector<std::string> infer(const std::vector<cv::Mat>& img_list);
 
+    // 同 infer，同时返回每条结果的平均置信度
+    std::vector<CtcResult> inferWithScores(const std::vector<cv::Mat>& img_list);
+
     std::vector<float> infer(const std::vector<cv::Mat>& norm_img_batch, int batch_width, std::vector<int>& predict_shape);
 
+    // 单张图像按推理时的规则（含宽度分桶）确定输入宽度并完成前处理，返回 [1, 3, recImgH, width] 的数据，
+    // INT8 标定数据由此生成
+    std::vector<float> preprocessSingle(const cv::Mat& img, int& width);
+
+    // 推理后端是否加载成功
+    bool loaded() const { return backend_->loaded(); }
+
+    // 实际生效的计算精度：CPU 不支持 bf16 等情况下 Paddle 后端会回退到 fp32，非 Paddle 后端总是 fp32
+    const std::string& precision() const { return precision_; }
+
+    // 缓存命中/未命中计数
+    uint64_t cacheHits() const { return cacheHits_; }
+    uint64_t cacheMisses() const { return cacheMisses_; }
+
 private:
-    // 前处理
-    void preprocess(const std::vector<cv::Mat>& img_list, std::vector<cv::Mat>& norm_img_batch, int& batch_width);
+    // 识别一组图像，结果与输入一一对应；succeeded 非空时写出每张图像所在批次是否推理成功，
+    // 失败批次的结果为空
+    std::vector<CtcResult> recognize(const std::vector<cv::Mat>& img_list,
+                                     std::vector<bool>* succeeded = nullptr);
+
+    // 前处理：对 indices[begin, end) 对应的图像逐张融合缩放/归一化/CHW 排布，写入后端的输入缓冲区，
+    // 输出的 batch_num/batch_width 为分桶补齐后的实际推理形状
+    void preprocess(const std::vector<cv::Mat>& img_list, const std::vector<size_t>& indices,
+                    size_t begin, size_t end, int& batch_num, int& batch_width);
+
+    // 将 input 中 [begin, end) 位置的图像填充为空白（全 0 像素归一化后的值）
+    void fillBlank(float* input, int begin, int end, int batch_width);
+
+    // 对所有分桶形状各推理一次
+    void warmup();
+
+    // 以已准备好的输入执行推理，返回输出数据，失败时返回空指针
+    const float* run(std::vector<int>& predict_shape);
 
     // 后处理
-    std::vector<std::string> postprocess(const std::vector<float>& predict_batch, const std::vector<int>& predict_shape);
+    std::vector<CtcResult> postprocess(const float* predict_batch, const std::vector<int>& predict_shape);
 
-    // 模型相关
-    std::shared_ptr<paddle_infer::Predictor> predictor_;
+    // 推理后端，持有常驻的输入/输出缓冲区
+    std::unique_ptr<InferenceBackend> backend_;
+    int maxBatch_ = 0;  // 后端支持的最大 batch，0 表示不限
+    std::string precision_ = "fp32";
     Config config_;
+    cv::Mat resizeBuffer_;
 
     std::vector<std::string> labelList_;
+    CtcDecoder decoder_;
     std::vector<float> mean_ = {0.5f, 0.5f, 0.5f};
     std::vector<float> scale_ = {1 / 0.5f, 1 / 0.5f, 1 / 0.5f};
     bool isScale_ = true;
     std::vector<int> recImageShape_ = {3, config_.recImgH, config_.recImgW};
-    PaddleOCR::CrnnResizeImg resizeOp_;
-    PaddleOCR::Normalize normalizeOp_;
+    PaddleOCR::CrnnResizeNormPermute resizeNormPermuteOp_;
     PaddleOCR::PermuteBatch permuteOp_;
+
+    // ROI 指纹：灰度缩略图
+    struct CacheEntry {
+        std::vector<uchar> signature;
+        CtcResult result;
+    };
+    void computeSignature(const cv::Mat& img, std::vector<uchar>& signature);
+    bool lookupCache(const std::vector<uchar>& signature, CtcResult& result);
+    void storeCache(std::vector<uchar> signature, const CtcResult& result);
+
+    std::deque<CacheEntry> cache_;
+    cv::Mat thumb_;
+    std::atomic<uint64_t> cacheHits_{0};   // 计数可能在其他线程读取
+    std::atomic<uint64_t> cacheMisses_{0};
 };
 
 #endif // OCR_H 
\ No newline at end of file
@@ -36,6 +36,16 @@ public:
   virtual void Run(const std::vector<cv::Mat> &imgs, float *data) noexcept;
 };
 
+// CrnnResizeImg + Normalize + Permute 融合：缩放后一次完成归一化、
+// 右侧补齐和 HWC->CHW，直接写入 data 指向的 [3, imgH, imgW] 区域
+class CrnnResizeNormPermute {
+public:
+  virtual void Run(const cv::Mat &img, float *data, int imgH, int imgW,
+                   const std::vector<float> &mean,
+                   const std::vector<float> &scale, const bool is_scale,
+                   cv::Mat &resize_buffer) noexcept;
+};
+
 class ResizeImgType0 {
 public:
   virtual void Run(const cv::Mat &img, cv::Mat &resize_img,
@@ -0,0 +1,28 @@
+#ifndef OPENCV_DNN_BACKEND_H
+#define OPENCV_DNN_BACKEND_H
+
+#include <opencv2/dnn.hpp>
+#include <string>
+#include <vector>
+#include "inference_backend.h"
+
+// OpenCV DNN 后端：加载 ONNX 模型，逐张推理（报告的输入 batch 固定为 1）。
+// OpenCV DNN 不提供模型输入形状，由调用方给出，H/W 可为 -1
+class OpenCvDnnBackend : public InferenceBackend {
+public:
+    OpenCvDnnBackend(const std::string& modelPath, std::vector<int64_t> inputShape);
+
+    std::string name() const override { return "opencv_dnn"; }
+    std::vector<int64_t> inputShape() const override { return inputShape_; }
+    float* prepareInput(const std::vector<int64_t>& shape) override;
+    const float* run(std::vector<int64_t>& outputShape) override;
+
+private:
+    cv::dnn::Net net_;
+    std::vector<int64_t> inputShape_;
+    std::vector<int> blobShape_;
+    std::vector<float> inputBuffer_;
+    cv::Mat output_;  // 持有最近一次推理的输出
+};
+
+#endif // OPENCV_DNN_BACKEND_H
@@ -0,0 +1,46 @@
+#ifndef ORT_BACKEND_H
+#define ORT_BACKEND_H
+
+#include <onnxruntime_cxx_api.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "inference_backend.h"
+
+// ONNX Runtime 后端：IoBinding 绑定常驻的输入输出缓冲区，只在 batch 变化时重新绑定
+class OrtBackend : public InferenceBackend {
+public:
+    OrtBackend(const std::string& modelPath, int intraOpNumThreads);
+    ~OrtBackend() override;
+
+    std::string name() const override { return "onnxruntime"; }
+    std::vector<int64_t> inputShape() const override { return inputShape_; }
+    float* prepareInput(const std::vector<int64_t>& shape) override;
+    const float* run(std::vector<int64_t>& outputShape) override;
+
+private:
+    Ort::Env env_;
+    Ort::SessionOptions sessionOptions_;
+    std::unique_ptr<Ort::Session> session_;
+
+    // 模型元数据
+    std::vector<const char*> inputNames_;
+    std::vector<const char*> outputNames_;
+    std::vector<int64_t> inputShape_;
+    std::vector<int64_t> outputShape_;
+
+    // IoBinding：输入输出缓冲区只绑定一次，形状变化时才重新绑定
+    Ort::MemoryInfo memoryInfo_;
+    Ort::RunOptions runOptions_;
+    std::unique_ptr<Ort::IoBinding> ioBinding_;
+    Ort::Value inputTensor_{nullptr};
+    Ort::Value outputTensor_{nullptr};
+    std::vector<float> inputTensorValues_;
+    std::vector<float> outputTensorValues_;
+    std::vector<Ort::Value> outputTensors_;  // 输出由 ORT 分配时持有其结果
+    std::vector<int64_t> boundInputShape_;
+    std::vector<int64_t> boundOutputShape_;
+    bool isStaticOutputShape_ = false;
+};
+
+#endif // ORT_BACKEND_H
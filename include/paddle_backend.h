@@ -0,0 +1,51 @@
+#ifndef PADDLE_BACKEND_H
+#define PADDLE_BACKEND_H
+
+#include <paddle_inference_api.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "inference_backend.h"
+
+// Paddle Inference 后端：输入通过 ShareExternalData 共享常驻缓冲区，省去 CopyFromCpu。
+// 默认使用 MKLDNN，openvino 为真时改用随 Paddle Inference 提供的 OpenVINO 引擎
+class PaddleBackend : public InferenceBackend {
+public:
+    struct Options {
+        int numThreads = 4;
+        int imgH = 32;                   // 识别模型输入高度
+        bool useMkldnn = true;
+        bool openvino = false;
+        // 计算精度：fp32 / bf16（需 CPU 支持 avx512_bf16 或 amx_bf16，否则回退 fp32）/
+        // int8（需 PaddleSlim 量化后的模型，走 MKLDNN int8 pass）；bf16 / int8 需开启 MKLDNN 或 OpenVINO
+        std::string precision = "fp32";
+    };
+
+    // modelDir 下需有 inference.pdmodel / inference.pdiparams
+    PaddleBackend(const std::string& modelDir, const Options& options);
+
+    // 实际生效的计算精度
+    const std::string& precision() const { return precision_; }
+
+    std::string name() const override { return openvino_ ? "paddle_openvino" : "paddle"; }
+    bool loaded() const override { return predictor_ != nullptr; }
+    std::vector<int64_t> inputShape() const override { return {-1, 3, imgH_, -1}; }
+    float* prepareInput(const std::vector<int64_t>& shape) override;
+    const float* run(std::vector<int64_t>& outputShape) override;
+
+private:
+    std::shared_ptr<paddle_infer::Predictor> predictor_;
+    // 输入输出句柄在推理器生命周期内有效，只获取一次
+    std::unique_ptr<paddle_infer::Tensor> inputHandle_;
+    std::unique_ptr<paddle_infer::Tensor> outputHandle_;
+    int imgH_;
+    bool openvino_;
+    std::string precision_;
+
+    // 常驻的输入/输出缓冲区，只增不减
+    std::vector<float> inputBuffer_;
+    std::vector<float> outputBuffer_;
+    std::vector<int> inputShape_;
+};
+
+#endif // PADDLE_BACKEND_H
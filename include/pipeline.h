@@ -0,0 +1,200 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bounded_queue.h"
+#include "yolo_wrapper.h"
+#include "ocr.h"
+#include "timer_tracker.h"
+#include "detection_scheduler.h"
+#include "frame_grabber.h"
+#include "frame_dumper.h"
+#include "video_encoder.h"
+#include "result_stream.h"
+#include "logger.h"
+#include "metrics.h"
+#include "backend_compare.h"
+
+// 信号灯运行状态
+enum class TrafficSignalStatus {
+    Normal,          // 正常
+    SignalMissing,   // 未检测到信号灯
+    TimerMissing     // 未检测到计时数字
+};
+
+// 命名的裁切区域，rect 面积为 0 表示整帧
+struct RegionOfInterest {
+    std::string name;
+    cv::Rect rect;
+    std::string light;  // 仅计时区域使用：所属信号灯区域的名称，为空则取同下标的信号灯区域
+};
+
+// 在流水线各阶段之间传递的单帧数据
+struct FramePacket {
+    size_t stream = 0;       // 所属视频流下标
+    int64_t index = 0;       // 流内帧序号
+    double timestampMs = 0;  // 视频时间戳或系统时钟（毫秒）
+    std::chrono::steady_clock::time_point captureTime;  // 解码完成时刻，用于统计端到端延迟
+    cv::Mat frame;
+    std::vector<std::vector<Detection>> detections;  // 每个信号灯区域的检测结果（原始帧坐标）
+    std::vector<std::string> timerValues;            // 每个计时区域的读数
+};
+
+// 单个阶段的处理统计
+struct StageStats {
+    std::string name;
+    std::atomic<uint64_t> frames{0};
+    std::atomic<int64_t> busyUs{0};
+};
+
+// 多路模式下单路视频流的配置
+struct StreamConfig {
+    std::string name;
+    std::string source;                       // 视频文件路径、流地址或摄像头索引
+    std::string videoOutputPath;              // 为空则不保存视频
+    std::vector<RegionOfInterest> lightROIs;  // 为空时使用全局区域配置
+    std::vector<RegionOfInterest> timerROIs;
+};
+
+// 分阶段多线程帧处理流水线：
+//   采集（每路一个线程） -> (YOLO 检测 || OCR 识别) -> 状态判定/绘制/编码
+// 阶段之间通过有界队列连接，检测与 OCR 并行执行，输出严格保持帧顺序。
+// 多路视频流共享同一组模型，检测和 OCR 阶段把来自不同流的帧合并为批量推理，
+// 区域跟踪、倒计时跟踪和状态判定按流独立维护
+class FramePipeline {
+public:
+    struct Config {
+        int queueCapacity = 4;           // 每个阶段间队列的容量
+        int reportInterval = 300;        // 每隔多少帧打印一次阶段占用（0 表示仅结束时打印）
+        bool display = false;            // 显示叠加结果窗口（按 ESC 退出），关闭时为无界面模式
+        int signalAnomalyThreshold = 30; // 信号灯异常阈值（帧数）
+        int ocrAnomalyThreshold = 60;    // OCR异常阈值（帧数）
+        std::vector<RegionOfInterest> lightROIs;  // 为空时对整帧检测
+        std::vector<RegionOfInterest> timerROIs;  // 为空时对整帧识别
+        FrameDumper::Config frameDump;   // 调试帧转储
+        VideoEncoder::Config videoEncoder;  // 视频输出的编码队列与溢出策略
+        ResultStream::Config resultStream;  // 结构化结果输出
+        Logger::Config logger;
+        Metrics::Config metrics;         // 延迟直方图与计数器导出
+        backend_compare::Config backendCompare;  // --compare-backends 时使用
+        int maxBatchFrames = 8;          // 检测/OCR 阶段单次最多合并的帧数（多路时生效）
+        std::string captureMode = "auto";  // auto（实时流取最新帧，视频文件逐帧）/ latest / sequential
+        int captureRingSize = 3;           // latest 模式下的采集环形缓冲区槽位数
+        TimerTracker::Config timerTracker;
+        DetectionScheduler::Config detectionScheduler;
+        std::vector<StreamConfig> streams;  // 多路视频流，为空时为单路模式
+    };
+
+    // 运行时的单路视频流
+    struct Stream {
+        std::string name;
+        cv::VideoCapture* cap = nullptr;
+        VideoEncoder* videoEncoder = nullptr;     // 可为空
+        std::vector<RegionOfInterest> lightROIs;  // 为空时使用 Config 中的区域
+        std::vector<RegionOfInterest> timerROIs;
+    };
+
+    // 单路
+    FramePipeline(const Config& config,
+                  cv::VideoCapture& cap,
+                  YOLOWrapper& yolo,
+                  OCRWrapper& ocr,
+                  VideoEncoder* videoEncoder,
+                  const std::vector<std::string>& classNames);
+
+    // 多路，所有视频流共享 yolo 和 ocr
+    FramePipeline(const Config& config,
+                  const std::vector<Stream>& streams,
+                  YOLOWrapper& yolo,
+                  OCRWrapper& ocr,
+                  const std::vector<std::string>& classNames);
+    ~FramePipeline();
+
+    // 运行流水线直到视频结束或在显示窗口中按下 ESC，返回处理的帧数
+    int64_t run();
+
+    // 打印各阶段吞吐和队列占用
+    void printReport() const;
+
+private:
+    using PacketPtr = std::shared_ptr<FramePacket>;
+
+    // 单路视频流的运行状态
+    struct StreamState {
+        Stream stream;
+        // 每个信号灯区域一个关键帧检测调度器，仅在检测线程中使用
+        std::vector<std::unique_ptr<DetectionScheduler>> detectionSchedulers;
+        // 每个计时区域一个倒计时跟踪器，仅在 OCR 线程中使用
+        std::vector<std::unique_ptr<TimerTracker>> timerTrackers;
+        std::vector<size_t> timerLightIndex;  // 计时区域对应的信号灯区域下标
+        // 状态判定，按区域计数，仅在绘制线程中使用
+        std::vector<int> signalAnomalyCounters;
+        std::vector<int> ocrAnomalyCounters;
+        TrafficSignalStatus status = TrafficSignalStatus::Normal;
+        // 上一帧的状态和颜色，用于判断状态变化
+        bool hasLastFrame = false;
+        TrafficSignalStatus lastStatus = TrafficSignalStatus::Normal;
+        std::string lastColor;
+        // 上一次输出到结果流的内容和时间
+        bool hasLastResult = false;
+        std::string lastResultKey;
+        double lastResultMs = 0;
+        std::atomic<uint64_t> frames{0};
+        bool useVideoClock = false;
+        std::unique_ptr<FrameGrabber> grabber;  // latest 模式下的采集线程
+    };
+
+    void addStream(const Stream& stream);
+    void captureLoop(size_t streamIndex);
+    void detectLoop();
+    void ocrLoop();
+    // 从队列中取出一批帧：阻塞等待第一帧，再非阻塞地补足到 maxBatchFrames
+    bool popBatch(BoundedQueue<PacketPtr>& queue, std::vector<PacketPtr>& batch);
+    // 将一批帧按轮次拆分，每轮每路最多一帧，保证同一路的跟踪状态按帧序更新
+    void splitRounds(const std::vector<PacketPtr>& batch, std::vector<std::vector<PacketPtr>>& rounds);
+    void detectRound(const std::vector<PacketPtr>& round);
+    void ocrRound(const std::vector<PacketPtr>& round);
+    void renderFrame(FramePacket& packet);
+    // 向 Metrics 注册队列深度、帧数和丢弃计数的采样回调
+    void registerMetrics();
+    void stop();
+
+    Config config_;
+    YOLOWrapper& yolo_;
+    OCRWrapper& ocr_;
+    const std::vector<std::string>& classNames_;
+    std::vector<std::unique_ptr<StreamState>> streams_;
+
+    // 多个采集线程需成对地向检测/OCR 队列入队，保证两个队列中的帧顺序一致
+    std::mutex captureMutex_;
+    std::atomic<int> activeCaptures_{0};
+
+    BoundedQueue<PacketPtr> detectInQueue_;
+    BoundedQueue<PacketPtr> ocrInQueue_;
+    BoundedQueue<PacketPtr> detectOutQueue_;
+    BoundedQueue<PacketPtr> ocrOutQueue_;
+
+    StageStats captureStats_;
+    StageStats detectStats_;
+    StageStats ocrStats_;
+    StageStats renderStats_;
+
+    FrameDumper frameDumper_;
+    ResultStream resultStream_;
+
+    std::vector<int> metricIds_;  // 注册到 Metrics 的采样回调，析构时注销
+
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopRequested_{false};
+    std::chrono::steady_clock::time_point startTime_;
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,38 @@
+#ifndef QUANTIZATION_H
+#define QUANTIZATION_H
+
+#include <string>
+#include <vector>
+
+// INT8 量化模型的精度报告与模型选择
+namespace quantization {
+    // 量化模型相对 FP32 模型的精度报告，由 yolo_calibrate / ocr_calibrate evaluate 在相同输入上对比生成
+    struct Report {
+        std::string fp32Model;
+        std::string int8Model;
+        int frames = 0;              // 检测为帧数，OCR 为区域图像数
+        double agreement = 0;        // 检测框一致率，OCR 为识别文本一致率
+        double labelAccuracy = -1;   // OCR 相对标注文本的准确率，-1 表示未评估
+        double recall = 0;           // FP32 框被 INT8 召回的比例
+        double precision = 0;        // INT8 框与 FP32 匹配的比例
+        double meanIou = 0;
+        double meanScoreDelta = 0;   // 匹配框置信度差的绝对值均值
+        double fp32LatencyMs = 0;    // 单次 infer 平均耗时（含前后处理），OCR 为每个区域的平均耗时
+        double int8LatencyMs = 0;
+    };
+
+    bool writeReport(const std::string& path, const Report& report);
+    bool readReport(const std::string& path, Report& report);
+
+    // 写出 numpy .npy（v1.0，float32，C 顺序），用于保存标定张量
+    bool writeNpy(const std::string& path, const float* data, const std::vector<int>& shape);
+
+    // 报告路径为空时默认为 int8Path + ".report.yaml"
+    std::string reportPathFor(const std::string& int8Path, const std::string& reportPath);
+
+    // 返回应加载的模型：报告存在且一致率不低于 minAgreement 时为 int8Path，否则（含 int8Path 为空）回退到 fp32Path
+    std::string selectModel(const std::string& fp32Path, const std::string& int8Path,
+                            const std::string& reportPath, double minAgreement);
+}
+
+#endif // QUANTIZATION_H
@@ -0,0 +1,49 @@
+#ifndef RESULT_STREAM_H
+#define RESULT_STREAM_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "async_writer.h"
+
+// 结构化结果流：每条记录为一行 JSON（JSONL），包含颜色、计时、状态和时间戳，
+// 在状态变化时或按固定间隔输出，经无锁缓冲区由后台线程写盘
+class ResultStream {
+public:
+    struct Config {
+        bool enable = false;
+        std::string path = "../results/results.jsonl";
+        bool onChange = true;        // 状态、颜色或计时读数变化时输出
+        double intervalMs = 1000;    // 按间隔输出（毫秒），0 表示仅在变化时输出
+        int ringCapacity = 1024;
+    };
+
+    struct Record {
+        std::string stream;
+        int64_t frame = 0;
+        double timestampMs = 0;      // 帧时间戳（视频时间戳或自启动以来的系统时钟）
+        std::string status;          // normal / signal_missing / timer_missing
+        std::string color;           // green / red / yellow，未检测到为空
+        std::vector<std::pair<std::string, std::string>> timers;  // (计时区域名称, 读数)
+    };
+
+    explicit ResultStream(const Config& config);
+    ~ResultStream();
+
+    // 是否需要输出：changed 为本帧相对上次输出是否有变化，sinceLastMs 为距上次输出的时间
+    bool due(bool changed, double sinceLastMs) const;
+
+    void emit(const Record& record);
+    void stop();
+
+    bool enabled() const { return config_.enable; }
+    uint64_t written() const { return writer_.written(); }
+    uint64_t dropped() const { return writer_.dropped(); }
+
+private:
+    Config config_;
+    AsyncWriter writer_;
+};
+
+#endif // RESULT_STREAM_H
@@ -0,0 +1,49 @@
+#ifndef STUB_BACKEND_H
+#define STUB_BACKEND_H
+
+#include <string>
+#include <vector>
+#include "inference_backend.h"
+
+// 桩后端：不加载模型，等待可配置的延迟后返回预先构造的固定输出，
+// 用于在没有模型文件时测试流水线、调度和 I/O 的吞吐与延迟
+class StubBackend : public InferenceBackend {
+public:
+    struct Config {
+        double delayMs = 5.0;      // 每次推理的固定延迟
+        double itemDelayMs = 1.0;  // batch 中每张图像追加的延迟
+        std::string text = "35";   // OCR 桩输出的识别文本
+    };
+
+    // inputShape 为模型输入形状（动态维度为 -1）；imageOutput 为单张图像的输出，
+    // 形状为 imageOutputShape（不含 batch 维），推理时按 batch 复制，与输入内容无关
+    StubBackend(const Config& config, std::vector<int64_t> inputShape,
+                std::vector<int64_t> imageOutputShape, std::vector<float> imageOutput);
+
+    std::string name() const override { return "stub"; }
+    std::vector<int64_t> inputShape() const override { return inputShape_; }
+    float* prepareInput(const std::vector<int64_t>& shape) override;
+    const float* run(std::vector<int64_t>& outputShape) override;
+
+    // v8 检测头单图输出 [4+C, A]：以 (cx, cy, w, h) 为中心的一个 classId 目标，
+    // 由少量相近的 anchor 组成（经 NMS 后剩一个框），其余 anchor 置信度为 0
+    static std::vector<float> detectionHead(int numClasses, int numAnchors, int classId,
+                                            float cx, float cy, float w, float h);
+
+    // CTC 单行概率 [T, C]：text 的每个字符占一个时间步，字符之间以 blank 隔开，其余为 blank
+    static std::vector<float> ctcProbabilities(const std::vector<std::string>& labels,
+                                               const std::string& text, int timeSteps);
+
+private:
+    Config config_;
+    std::vector<int64_t> inputShape_;
+    std::vector<int64_t> imageOutputShape_;
+    std::vector<float> imageOutput_;
+
+    std::vector<float> inputBuffer_;
+    std::vector<float> outputBuffer_;  // 按当前 batch 复制好的输出
+    int64_t batchSize_ = 0;
+    int64_t outputBatchSize_ = 0;
+};
+
+#endif // STUB_BACKEND_H
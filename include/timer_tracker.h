@@ -0,0 +1,58 @@
+#ifndef TIMER_TRACKER_H
+#define TIMER_TRACKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 倒计时跟踪器：倒计时每秒减一，锁定一次数字跳变的时刻后即可预测当前读数，
+// 只在预计跳变附近、周期性校验或即将换相时才需要运行 OCR，
+// 任何读数与预测不符都会解除锁定并退回逐帧 OCR
+class TimerTracker {
+public:
+    struct Config {
+        bool enable = false;
+        std::string clock = "auto";      // 时间戳来源：auto / video（CAP_PROP_POS_MSEC）/ wall（系统时钟）
+        double periodMs = 1000.0;        // 倒计时步长
+        double transitionWindowMs = 50;  // 预计跳变时刻前后该范围内运行 OCR
+        double verifyIntervalMs = 3000;  // 锁定状态下的周期校验间隔
+        double maxAnchorGapMs = 250;     // 两次相邻 OCR 间隔不超过该值时才用于估计跳变时刻
+    };
+
+    TimerTracker() = default;
+    explicit TimerTracker(const Config& config) : config_(config) {}
+
+    // 在该时间戳是否需要运行 OCR
+    bool shouldRunOcr(double timestampMs) const;
+
+    // 提交一次 OCR 读数，返回对外输出的计时值（数字读数去掉前导零，与 predict 一致）
+    std::string update(double timestampMs, const std::string& reading);
+
+    // 跳过 OCR 时输出的预测值，并计入跳过次数
+    std::string predict(double timestampMs);
+
+    bool locked() const { return locked_; }
+    uint64_t ocrRuns() const { return ocrRuns_; }
+    uint64_t ocrSkips() const { return ocrSkips_; }
+
+private:
+    // 锁定状态下 timestampMs 时刻的预测数值
+    int predictValue(double timestampMs) const;
+    void lock(int value, double transitionMs);
+
+    Config config_;
+
+    std::atomic<bool> locked_{false};
+    int anchorValue_ = 0;        // 锁定的数值
+    double anchorMs_ = 0;        // anchorValue_ 开始显示的时刻
+
+    bool hasLastReading_ = false;
+    int lastValue_ = 0;
+    double lastOcrMs_ = 0;
+    std::string lastReading_;
+
+    std::atomic<uint64_t> ocrRuns_{0};   // 计数可能在其他线程读取
+    std::atomic<uint64_t> ocrSkips_{0};
+};
+
+#endif // TIMER_TRACKER_H
@@ -5,17 +5,12 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <functional>
 #include "yolo_wrapper.h"
 #include "ocr.h"
+#include "pipeline.h"
 
-// 定义状态变量
-enum class TrafficSignalStatus {
-    Normal,          // 正常
-    SignalMissing,   // 未检测到信号灯
-    TimerMissing     // 未检测到计时数字
-};
-
-extern TrafficSignalStatus currentStatus;  // 当前状态
+extern TrafficSignalStatus currentStatus;  // 当前状态（多路时为第一路）
 
 // 命令行参数解析
 std::string parseCommandLineArgs(int argc, char* argv[], const std::string& defaultPath);
@@ -25,12 +20,24 @@ bool loadConfig(const std::string& configPath,
                std::string& videoSource,
                YOLOWrapper::Config& yoloConfig,
                OCRWrapper::Config& ocrConfig,
-               cv::Rect& signalLightROI,
-               cv::Rect& timerROI,
                bool& enableVideoOutput,
                std::string& videoOutputPath,
                std::string& videoCodec,
-               int& videoFps);
+               int& videoFps,
+               FramePipeline::Config& pipelineConfig);
+
+// 按区域裁切，面积为 0 时（默认配置 0x0）返回整帧，超出画面的部分被裁掉；
+// 流水线、后端对比和标定工具共用，保证各处的输入一致
+cv::Mat cropROI(const cv::Mat& frame, const cv::Rect& roi);
+
+// 按一组区域裁切，rois 为空时返回整帧；完全在画面外的区域被跳过
+std::vector<cv::Mat> cropROIs(const cv::Mat& frame, const std::vector<cv::Rect>& rois);
+
+// 从多个视频中抽取标定样本：样本数按视频平均分配，每个视频从头每 stride 帧取一帧。
+// visit(frame, video, index, budget) 处理一帧并返回实际取用的样本数（不超过 budget），负数表示出错。
+// 返回样本总数，出错时返回 -1
+int sampleVideos(const std::vector<std::string>& videos, int samples, int stride,
+                 const std::function<int(const cv::Mat&, const std::string&, int, int)>& visit);
 
 // 读取标签文件
 std::vector<std::string> ReadDict(const std::string &path) noexcept;
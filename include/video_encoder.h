@@ -0,0 +1,76 @@
+#ifndef VIDEO_ENCODER_H
+#define VIDEO_ENCODER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bounded_queue.h"
+
+// 后台视频编码：处理线程只把帧交给编码队列（共享数据，不做深拷贝），
+// 编码和写盘在独立线程中完成。队列满时按策略处理：
+//   block     - 阻塞等待，不丢帧
+//   drop      - 丢弃该帧并计数
+//   downscale - 以缩小后的分辨率编码（在提交时缩放到复用的缓冲区），队列满时丢弃
+class VideoEncoder {
+public:
+    struct Config {
+        int queueCapacity = 8;
+        std::string overflowPolicy = "block";  // block / drop / downscale
+        double downscale = 0.5;                // downscale 策略下的缩放比例
+    };
+
+    explicit VideoEncoder(const Config& config);
+    ~VideoEncoder();
+
+    // frameSize 为输入帧尺寸，downscale 策略下按缩放后的尺寸打开
+    bool open(const std::string& path, int fourcc, double fps, cv::Size frameSize);
+    bool isOpened() const { return writer_.isOpened(); }
+
+    // 提交一帧；frame 与调用方共享数据，提交后调用方不应再修改。被丢弃时返回 false
+    bool write(const cv::Mat& frame);
+
+    // 写完队列中剩余的帧并关闭文件
+    void release();
+
+    uint64_t written() const { return written_; }
+    uint64_t dropped() const { return dropped_; }
+    size_t pending() const { return queue_.size(); }
+    double blockedMs() const { return queue_.blockedMs(); }
+    // 编码延迟：从提交到写入完成的时间
+    double averageLagMs() const;
+    double maxLagMs() const { return maxLagUs_ / 1000.0; }
+
+private:
+    struct Job {
+        cv::Mat frame;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    void encodeLoop();
+    // 取一个未被队列引用的缩放缓冲区
+    cv::Mat& acquireBuffer();
+
+    Config config_;
+    bool dropWhenFull_ = false;
+    bool scaled_ = false;
+    cv::Size outputSize_;
+    cv::VideoWriter writer_;
+    BoundedQueue<Job> queue_;
+    std::thread thread_;
+    std::mutex releaseMutex_;
+
+    std::vector<cv::Mat> buffers_;  // 缩放缓冲区池，仅在提交线程中使用
+    size_t nextBuffer_ = 0;
+
+    std::atomic<uint64_t> written_{0};   // 计数可能在其他线程读取
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<int64_t> lagUsSum_{0};
+    std::atomic<int64_t> maxLagUs_{0};
+};
+
+#endif // VIDEO_ENCODER_H
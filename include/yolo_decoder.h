@@ -0,0 +1,27 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "detection.h"
+
+namespace yolo_decoder {
+    // 检测头输出布局
+    enum class HeadLayout {
+        V8,  // YOLOv8/v11：[4+C, A]，通道优先，无 objectness
+        V5   // YOLOv5：[A, 5+C]，anchor 优先，带 objectness
+    };
+
+    struct Params {
+        HeadLayout layout = HeadLayout::V8;
+        int numClasses = 0;
+        int numAnchors = 0;
+        float confThreshold = 0.25f;
+    };
+
+    // 根据单张图像的输出维度 [dim1, dim2] 和配置的 head 类型（"auto"/"v8"/"v5"）推断解码参数
+    Params resolveParams(const std::string& head, int dim1, int dim2, float confThreshold);
+
+    // 原地解码单张图像的输出，置信度超过阈值的候选框（letterbox 坐标系）追加到 candidates
+    // 常见类别数有编译期特化版本，其余走运行期类别数的通用版本
+    void decode(const float* output, const Params& params, std::vector<Detection>& candidates);
+}
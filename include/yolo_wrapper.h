@@ -1,14 +1,12 @@
 #pragma once
 #include <opencv2/opencv.hpp>
-#include <onnxruntime_cxx_api.h>
 #include <vector>
 #include <memory>
-
-struct Detection {
-    cv::Rect box;
-    float confidence;
-    int classId;
-};
+#include "detection.h"
+#include "yolo_decoder.h"
+#include "nms.h"
+#include "inference_backend.h"
+#include "stub_backend.h"
 
 class YOLOWrapper {
 public:
@@ -17,6 +15,18 @@ public:
         float confThreshold = 0.5;
         float iouThreshold = 0.45;
         int intraOpNumThreads = 4;
+        std::string head = "auto";  // 检测头类型：auto / v8（含 v11）/ v5
+        bool classAgnosticNms = false;  // NMS 是否忽略类别
+        int nmsTopK = 1000;             // 进入 NMS 的最大候选数
+        int maxDetections = 100;        // 每张图像最多输出的框数
+        std::string backend = "onnxruntime";  // 推理后端：onnxruntime / opencv_dnn / stub（不加载模型，返回固定输出）
+        StubBackend::Config stub;
+
+        // INT8 量化模型（tools/ 下的标定与量化工具生成），仅 onnxruntime / opencv_dnn 后端：
+        // 精度报告中与 FP32 的一致率不低于 int8MinAgreement 时加载，报告缺失或不达标时回退到 modelPath
+        std::string int8ModelPath;
+        std::string int8ReportPath;  // 为空时为 int8ModelPath + ".report.yaml"
+        double int8MinAgreement = 0.95;
     };
 
     YOLOWrapper(const Config& config);
@@ -24,32 +34,49 @@ public:
     
     std::vector<Detection> infer(cv::Mat& frame);
 
+    // 批量推理：N 张图像 letterbox 后拼成一个 NCHW 张量，单次 Run 后按图像拆分结果
+    // 固定 batch 的模型按模型 batch 分组并补齐，动态 batch 的模型一次送入全部图像
+    std::vector<std::vector<Detection>> infer(const std::vector<cv::Mat>& frames);
+
+    // 推理后端是否加载成功
+    bool loaded() const { return backend_->loaded(); }
+
+    // 实际加载的模型路径（INT8 或回退后的 FP32）
+    const std::string& activeModelPath() const { return activeModelPath_; }
+
+    // letterbox 目标尺寸 (W, H)
+    cv::Size inputSize() const { return inputSize_; }
+
+    // 预处理：单趟融合内核，结果以 CHW 写入 blob 指向的位置（3 * inputSize().area() 个 float），
+    // INT8 标定数据也由此生成，保证与推理时的输入分布一致
+    void preprocess(const cv::Mat& image, float* blob);
+
 private:
-    // ONNX Runtime 相关
-    Ort::Env env_;
-    Ort::SessionOptions sessionOptions_;
-    std::unique_ptr<Ort::Session> session_;
-    
-    // 模型元数据
-    std::vector<const char*> inputNames_;
-    std::vector<const char*> outputNames_;
+    // 推理后端（ONNX Runtime 或桩实现）
+    std::unique_ptr<InferenceBackend> backend_;
     std::vector<int64_t> inputShape_;
-    std::vector<int64_t> outputShape_;
-    
+    std::string activeModelPath_;
+
     // 配置参数
     Config config_;
     bool isDynamicInputShape_ = false;
-    
-    // 预处理
-    void preprocess(cv::Mat& image, float*& blob, std::vector<int64_t>& tensorShape);
-    
-    // 后处理
-    std::vector<Detection> postprocess(
-        const cv::Size& resizedImageShape,
-        const cv::Size& originalImageShape,
-        std::vector<Ort::Value>& outputTensors
-    );
-
-    // 获取最佳类别信息
-    void getBestClassInfo(std::vector<float>::iterator it, float& bestConf, int& bestClassId);
+    bool isDynamicBatch_ = false;
+    cv::Size inputSize_;  // letterbox 目标尺寸 (W, H)
+    cv::Mat resizeBuffer_;
+
+    // 单批次推理，frames 数量不超过模型 batch
+    void inferBatch(const cv::Mat* frames, size_t count, int64_t batchSize,
+                    std::vector<std::vector<Detection>>& results);
+
+    // 检测头解码参数，输出形状变化时重新确定
+    yolo_decoder::Params decodeParams_;
+    int64_t resolvedDim1_ = 0;
+    int64_t resolvedDim2_ = 0;
+    nms_utils::Options nmsOptions_;
+
+    // 后处理：output 指向 batch 的检测头输出，每张图像占 imageOutputSize 个 float，
+    // 原地解码后执行批量 NMS，结果追加到 results
+    void postprocess(const cv::Mat* frames, size_t count,
+                     const float* output, size_t imageOutputSize,
+                     std::vector<std::vector<Detection>>& results);
 }; 
\ No newline at end of file
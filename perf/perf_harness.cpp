@@ -0,0 +1,304 @@
+// 端到端性能回归：生成一段合成视频，用桩推理后端（固定输出 + 可配置延迟）驱动真实的
+// FramePipeline，检查吞吐和 p99 帧延迟预算，并与存储的基线对比。无需模型文件。
+//
+//   ./perf_harness --baseline perf/baseline.yaml --scenario single [--output result.yaml] [--update-baseline]
+#include <opencv2/opencv.hpp>
+#include <yaml-cpp/yaml.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "pipeline.h"
+#include "data.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// 场景参数，来自基线文件 scenarios.<name>
+struct Scenario {
+    int frames = 300;
+    int streams = 1;
+    int width = 1280;
+    int height = 720;
+    double yoloDelayMs = 6;
+    double yoloItemDelayMs = 2;
+    double ocrDelayMs = 4;
+    double ocrItemDelayMs = 1;
+    bool keyframeScheduling = true;  // 关键帧检测与倒计时跟踪
+    // 预算
+    double minFps = 0;
+    double maxP99Ms = 0;
+};
+
+struct Measurement {
+    double fps = 0;
+    double p50Ms = 0;
+    double p99Ms = 0;
+    map<string, double> stageP99Ms;  // 各阶段 p99（仅报告，不作为失败条件）
+};
+
+// 合成视频：画面中央为按周期换色的信号灯，右上角计时区域内为每秒减一的倒计时。
+// 信号灯位置与桩检测头输出的框一致
+void writeClip(const string& path, const Scenario& scenario) {
+    const double fps = 30;
+    VideoWriter writer(path, VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, Size(scenario.width, scenario.height));
+    if (!writer.isOpened()) {
+        cerr << "Error: Could not write the test clip " << path << endl;
+        exit(2);
+    }
+    const Scalar colors[] = {Scalar(0, 200, 0), Scalar(0, 200, 200), Scalar(0, 0, 220)};
+    Mat frame(scenario.height, scenario.width, CV_8UC3);
+    for (int i = 0; i < scenario.frames; ++i) {
+        frame.setTo(Scalar(40, 40, 40));
+        int phase = (i / 90) % 3;
+        Point center(scenario.width / 2, scenario.height / 2);
+        rectangle(frame, Rect(center.x - 40, center.y - 100, 80, 200), Scalar(10, 10, 10), FILLED);
+        circle(frame, Point(center.x, center.y - 60 + phase * 60), 30, colors[phase], FILLED);
+        int countdown = 30 - (i / (int)fps) % 30;
+        putText(frame, to_string(countdown), Point(scenario.width - 190, 300),
+                FONT_HERSHEY_SIMPLEX, 3.0, Scalar(0, 0, 255), 6);
+        writer.write(frame);
+    }
+}
+
+Measurement runScenario(const Scenario& scenario, const string& clipPath) {
+    YOLOWrapper::Config yoloConfig;
+    yoloConfig.backend = "stub";
+    yoloConfig.confThreshold = 0.25f;
+    yoloConfig.stub.delayMs = scenario.yoloDelayMs;
+    yoloConfig.stub.itemDelayMs = scenario.yoloItemDelayMs;
+
+    OCRWrapper::Config ocrConfig;
+    ocrConfig.backend = "stub";
+    ocrConfig.charset = "0123456789";
+    ocrConfig.cacheEnable = true;
+    ocrConfig.bucketEnable = true;
+    ocrConfig.bucketWarmup = false;
+    ocrConfig.stub.delayMs = scenario.ocrDelayMs;
+    ocrConfig.stub.itemDelayMs = scenario.ocrItemDelayMs;
+
+    FramePipeline::Config pipelineConfig;
+    pipelineConfig.reportInterval = 0;
+    pipelineConfig.timerROIs.push_back(RegionOfInterest{"timer", Rect(scenario.width - 200, 180, 200, 150), ""});
+    pipelineConfig.detectionScheduler.enable = scenario.keyframeScheduling;
+    pipelineConfig.timerTracker.enable = scenario.keyframeScheduling;
+
+    YOLOWrapper yolo(yoloConfig);
+    OCRWrapper ocr(ocrConfig);
+    vector<string> classNames = {"Green", "Red", "Yellow"};
+    data_utils::loadNames(classNames);
+
+    vector<unique_ptr<VideoCapture>> caps;
+    vector<FramePipeline::Stream> streams;
+    for (int i = 0; i < scenario.streams; ++i) {
+        caps.emplace_back(new VideoCapture(clipPath));
+        if (!caps.back()->isOpened()) {
+            cerr << "Error: Cannot open the test clip " << clipPath << endl;
+            exit(2);
+        }
+        FramePipeline::Stream stream;
+        stream.name = "cam" + to_string(i);
+        stream.cap = caps.back().get();
+        streams.push_back(stream);
+    }
+
+    auto start = chrono::steady_clock::now();
+    int64_t processed = 0;
+    if (scenario.streams == 1) {
+        FramePipeline pipeline(pipelineConfig, *caps[0], yolo, ocr, nullptr, classNames);
+        processed = pipeline.run();
+    } else {
+        FramePipeline pipeline(pipelineConfig, streams, yolo, ocr, classNames);
+        processed = pipeline.run();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    Measurement m;
+    m.fps = seconds > 0 ? processed / seconds : 0;
+    Metrics& metrics = Metrics::instance();
+    LatencyHistogram* latency = metrics.histogram("frame_latency");
+    m.p50Ms = latency->quantileUs(0.5) / 1000.0;
+    m.p99Ms = latency->quantileUs(0.99) / 1000.0;
+    for (const char* stage : {"decode", "yolo_run", "ocr_run", "detect", "ocr", "render"}) {
+        LatencyHistogram* histogram = metrics.histogram(stage);
+        if (histogram->count() > 0) {
+            m.stageP99Ms[stage] = histogram->quantileUs(0.99) / 1000.0;
+        }
+    }
+    return m;
+}
+
+// 当前机器的 CPU 型号与逻辑核数，记录为基线的参考机器
+YAML::Node machineNode() {
+    YAML::Node node;
+    ifstream cpuinfo("/proc/cpuinfo");
+    string line;
+    int cores = 0;
+    while (getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0 && !node["cpu"]) {
+            size_t colon = line.find(':');
+            node["cpu"] = colon == string::npos ? line : line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+        if (line.compare(0, 9, "processor") == 0) cores++;
+    }
+    node["cores"] = cores;
+    return node;
+}
+
+YAML::Node toNode(const Measurement& m) {
+    YAML::Node node;
+    node["fps"] = m.fps;
+    node["p50_ms"] = m.p50Ms;
+    node["p99_ms"] = m.p99Ms;
+    for (const auto& stage : m.stageP99Ms) {
+        node["stage_p99_ms"][stage.first] = stage.second;
+    }
+    return node;
+}
+
+// 一行对比：higherIsBetter 为真时下降超过容差视为回归
+bool compareLine(const string& metric, double current, const YAML::Node& baseline,
+                 bool higherIsBetter, double tolerance, bool enforce) {
+    cout << "  " << left << setw(22) << metric << right << fixed << setprecision(2)
+         << setw(12) << current;
+    if (!baseline) {
+        cout << setw(12) << "-" << setw(10) << "-" << endl;
+        return true;
+    }
+    double base = baseline.as<double>();
+    double delta = base != 0 ? (current - base) / base : 0;
+    bool regressed = higherIsBetter ? delta < -tolerance : delta > tolerance;
+    cout << setw(12) << base << setw(9) << showpos << delta * 100 << "%" << noshowpos;
+    if (regressed) cout << (enforce ? "  REGRESSION" : "  (slower)");
+    cout << endl;
+    return !(regressed && enforce);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    string baselinePath = "perf/baseline.yaml";
+    string scenarioName = "single";
+    string outputPath;
+    string clipPath;
+    bool updateBaseline = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "--scenario" && i + 1 < argc) scenarioName = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+        else if (arg == "--clip" && i + 1 < argc) clipPath = argv[++i];
+        else if (arg == "--update-baseline") updateBaseline = true;
+        else {
+            cerr << "Usage: " << argv[0] << " [--baseline path] [--scenario name] [--output path]"
+                 << " [--clip path] [--update-baseline]" << endl;
+            return 2;
+        }
+    }
+
+    YAML::Node baseline;
+    try {
+        baseline = YAML::LoadFile(baselinePath);
+    } catch (const YAML::Exception& e) {
+        cerr << "Error: Could not load baseline " << baselinePath << ": " << e.what() << endl;
+        return 2;
+    }
+    YAML::Node scenarioNode = baseline["scenarios"][scenarioName];
+    if (!scenarioNode) {
+        cerr << "Error: Unknown scenario " << scenarioName << endl;
+        return 2;
+    }
+    double tolerance = baseline["tolerance"].as<double>(0.2);
+
+    Scenario scenario;
+    scenario.frames = scenarioNode["frames"].as<int>(scenario.frames);
+    scenario.streams = scenarioNode["streams"].as<int>(scenario.streams);
+    scenario.width = scenarioNode["width"].as<int>(scenario.width);
+    scenario.height = scenarioNode["height"].as<int>(scenario.height);
+    scenario.yoloDelayMs = scenarioNode["yolo_delay_ms"].as<double>(scenario.yoloDelayMs);
+    scenario.yoloItemDelayMs = scenarioNode["yolo_item_delay_ms"].as<double>(scenario.yoloItemDelayMs);
+    scenario.ocrDelayMs = scenarioNode["ocr_delay_ms"].as<double>(scenario.ocrDelayMs);
+    scenario.ocrItemDelayMs = scenarioNode["ocr_item_delay_ms"].as<double>(scenario.ocrItemDelayMs);
+    scenario.keyframeScheduling = scenarioNode["keyframe_scheduling"].as<bool>(scenario.keyframeScheduling);
+    scenario.minFps = scenarioNode["budgets"]["min_fps"].as<double>(0);
+    scenario.maxP99Ms = scenarioNode["budgets"]["max_p99_ms"].as<double>(0);
+
+    // 日志只保留警告，统计与结果由本程序输出
+    Logger::Config loggerConfig;
+    loggerConfig.level = "warn";
+    Logger::instance().start(loggerConfig);
+    Metrics::Config metricsConfig;
+    metricsConfig.enable = true;
+    metricsConfig.httpPort = 0;
+    Metrics::instance().start(metricsConfig);
+
+    if (clipPath.empty()) {
+        clipPath = "perf_clip_" + to_string(scenario.width) + "x" + to_string(scenario.height) +
+                   "_" + to_string(scenario.frames) + ".avi";
+    }
+    if (!ifstream(clipPath)) {
+        writeClip(clipPath, scenario);
+    }
+
+    Measurement m = runScenario(scenario, clipPath);
+    Metrics::instance().stop();
+    Logger::instance().stop();
+
+    // 对比报告：预算为硬性条件，基线用于发现超出容差的回归
+    YAML::Node base = scenarioNode["results"];
+    bool ok = true;
+    cout << "========== 性能回归: " << scenarioName << " ==========" << endl;
+    YAML::Node machine = machineNode();
+    YAML::Node reference = baseline["reference_machine"];
+    if (base && reference && reference["cpu"].as<string>("") != machine["cpu"].as<string>("")) {
+        cout << "  注意: 基线记录于 " << reference["cpu"].as<string>("") << "（" << reference["cores"].as<int>(0)
+             << " 核），当前为 " << machine["cpu"].as<string>("") << "（" << machine["cores"].as<int>(0)
+             << " 核），差异可能来自机器而非代码" << endl;
+    }
+    cout << "  " << left << setw(22) << "metric" << right << setw(12) << "current"
+         << setw(12) << "baseline" << setw(10) << "delta" << endl;
+    ok &= compareLine("fps", m.fps, base["fps"], true, tolerance, true);
+    ok &= compareLine("frame_latency_p50_ms", m.p50Ms, base["p50_ms"], false, tolerance, false);
+    ok &= compareLine("frame_latency_p99_ms", m.p99Ms, base["p99_ms"], false, tolerance, true);
+    for (const auto& stage : m.stageP99Ms) {
+        YAML::Node stageBase = base["stage_p99_ms"] ? base["stage_p99_ms"][stage.first] : YAML::Node();
+        compareLine(stage.first + "_p99_ms", stage.second, stageBase, false, tolerance, false);
+    }
+    if (!base) {
+        cout << "  WARNING: 基线中没有该场景的结果，未做回归对比，仅检查预算；"
+             << "请在参考机器上运行 --update-baseline 记录并提交" << endl;
+    }
+    if (scenario.minFps > 0 && m.fps < scenario.minFps) {
+        cout << "  FAIL: fps " << m.fps << " < budget " << scenario.minFps << endl;
+        ok = false;
+    }
+    if (scenario.maxP99Ms > 0 && m.p99Ms > scenario.maxP99Ms) {
+        cout << "  FAIL: p99 " << m.p99Ms << " ms > budget " << scenario.maxP99Ms << " ms" << endl;
+        ok = false;
+    }
+
+    if (!outputPath.empty()) {
+        YAML::Node output;
+        output["scenario"] = scenarioName;
+        output["results"] = toNode(m);
+        ofstream out(outputPath);
+        out << output << endl;
+    }
+    if (updateBaseline) {
+        baseline["scenarios"][scenarioName]["results"] = toNode(m);
+        baseline["reference_machine"] = machine;
+        ofstream out(baselinePath);
+        out << baseline << endl;
+        cout << "基线已更新: " << baselinePath << endl;
+    }
+
+    cout << (ok ? "PASS" : "FAIL") << endl;
+    return ok ? 0 : 1;
+}
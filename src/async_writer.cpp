@@ -0,0 +1,70 @@
+#include "async_writer.h"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+AsyncWriter::~AsyncWriter() {
+    stop();
+}
+
+bool AsyncWriter::start(const string& path, size_t capacity, int flushIntervalMs) {
+    if (started_) return true;
+    if (path.empty()) {
+        file_ = stdout;
+        ownsFile_ = false;
+    } else {
+        file_ = fopen(path.c_str(), "a");
+        if (!file_) {
+            cerr << "Error: Could not open " << path << " for write" << endl;
+            return false;
+        }
+        ownsFile_ = true;
+    }
+    ring_.reset(new MessageRing<kSlotSize>(capacity));
+    flushIntervalMs_ = max(1, flushIntervalMs);
+    stopRequested_ = false;
+    started_ = true;
+    thread_ = thread(&AsyncWriter::sinkLoop, this);
+    return true;
+}
+
+void AsyncWriter::stop() {
+    if (!started_) return;
+    stopRequested_ = true;
+    if (thread_.joinable()) thread_.join();
+    started_ = false;
+    if (ownsFile_ && file_) {
+        fclose(file_);
+    }
+    file_ = nullptr;
+}
+
+bool AsyncWriter::write(const string& line, bool truncate) {
+    if (!started_ || !ring_->tryPush(line.data(), line.size(), truncate)) {
+        dropped_++;
+        return false;
+    }
+    return true;
+}
+
+void AsyncWriter::sinkLoop() {
+    string line;
+    for (;;) {
+        // 取空缓冲区后统一刷新一次，而不是每行刷新
+        bool any = false;
+        while (ring_->tryPop(line)) {
+            fwrite(line.data(), 1, line.size(), file_);
+            fputc('\n', file_);
+            written_++;
+            any = true;
+        }
+        if (any) {
+            fflush(file_);
+        } else if (stopRequested_) {
+            break;
+        } else {
+            this_thread::sleep_for(chrono::milliseconds(flushIntervalMs_));
+        }
+    }
+}
@@ -0,0 +1,228 @@
+#include "backend_compare.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include "nms.h"
+#include "utils.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+struct Timing {
+    string backend;
+    bool ok = false;
+    string error;
+    vector<double> latencyMs;
+    double agreement = -1;  // 与参考后端的一致率，-1 表示参考后端自身
+};
+
+double percentile(vector<double> values, double q) {
+    if (values.empty()) return 0;
+    sort(values.begin(), values.end());
+    return values[min(values.size() - 1, (size_t)(q * (values.size() - 1) + 0.5))];
+}
+
+double detectionAgreement(const vector<vector<vector<Detection>>>& reference,
+                          const vector<vector<vector<Detection>>>& results) {
+    backend_compare::DetectionDelta delta;
+    for (size_t f = 0; f < reference.size() && f < results.size(); ++f) {
+        for (size_t r = 0; r < reference[f].size() && r < results[f].size(); ++r) {
+            backend_compare::compareDetections(reference[f][r], results[f][r], delta);
+        }
+    }
+    return delta.agreement();
+}
+
+double textAgreement(const vector<vector<string>>& reference, const vector<vector<string>>& results) {
+    size_t same = 0, total = 0;
+    for (size_t f = 0; f < reference.size() && f < results.size(); ++f) {
+        for (size_t r = 0; r < reference[f].size() && r < results[f].size(); ++r) {
+            same += reference[f][r] == results[f][r];
+            total++;
+        }
+    }
+    return total ? (double)same / total : 1.0;
+}
+
+void printTable(const string& model, const vector<Timing>& timings) {
+    cout << "---------- " << model << " 后端对比（含相同的前后处理） ----------" << endl;
+    cout << left << setw(18) << "backend" << right << setw(10) << "mean ms" << setw(10) << "p50 ms"
+         << setw(10) << "p99 ms" << setw(12) << "agreement" << endl;
+    for (const Timing& t : timings) {
+        cout << left << setw(18) << t.backend << right;
+        if (!t.ok) {
+            cout << "  failed: " << t.error << endl;
+            continue;
+        }
+        double sum = 0;
+        for (double v : t.latencyMs) sum += v;
+        cout << fixed << setprecision(2)
+             << setw(10) << sum / max<size_t>(1, t.latencyMs.size())
+             << setw(10) << percentile(t.latencyMs, 0.5)
+             << setw(10) << percentile(t.latencyMs, 0.99);
+        if (t.agreement < 0) {
+            cout << setw(12) << "reference";
+        } else {
+            cout << setw(11) << t.agreement * 100 << "%";
+        }
+        cout << endl;
+    }
+}
+
+} // namespace
+
+void backend_compare::compareDetections(const vector<Detection>& reference,
+                                        const vector<Detection>& candidate,
+                                        DetectionDelta& delta, float iouThreshold) {
+    vector<size_t> order(reference.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return reference[a].confidence > reference[b].confidence;
+    });
+
+    delta.referenceBoxes += reference.size();
+    delta.candidateBoxes += candidate.size();
+    vector<bool> used(candidate.size(), false);
+    for (size_t i : order) {
+        const Detection& ref = reference[i];
+        if (ref.classId < 0) continue;
+        if ((size_t)ref.classId >= delta.classReference.size()) {
+            delta.classReference.resize(ref.classId + 1, 0);
+            delta.classMatched.resize(ref.classId + 1, 0);
+        }
+        delta.classReference[ref.classId]++;
+
+        int best = -1;
+        float bestIou = iouThreshold;
+        for (size_t j = 0; j < candidate.size(); ++j) {
+            if (used[j] || candidate[j].classId != ref.classId) continue;
+            float iou = nms_utils::iou(ref.box, candidate[j].box);
+            if (iou >= bestIou) {
+                best = (int)j;
+                bestIou = iou;
+            }
+        }
+        if (best < 0) continue;
+        used[best] = true;
+        delta.matched++;
+        delta.classMatched[ref.classId]++;
+        delta.iouSum += bestIou;
+        delta.scoreDeltaSum += std::abs(ref.confidence - candidate[best].confidence);
+    }
+}
+
+int backend_compare::run(const Config& config,
+                         const string& videoSource,
+                         const YOLOWrapper::Config& yoloConfig,
+                         const OCRWrapper::Config& ocrConfig,
+                         const vector<Rect>& lightROIs,
+                         const vector<Rect>& timerROIs) {
+    VideoCapture cap(videoSource);
+    if (!cap.isOpened()) {
+        cerr << "Error: Cannot open the video stream!" << endl;
+        return -1;
+    }
+    // 预先解码全部输入，各后端使用完全相同的帧
+    int total = config.warmup + config.frames;
+    vector<Mat> frames;
+    Mat frame;
+    while ((int)frames.size() < total && cap.read(frame)) {
+        frames.push_back(frame.clone());
+    }
+    if ((int)frames.size() <= config.warmup) {
+        cerr << "Error: Not enough frames for backend comparison" << endl;
+        return -1;
+    }
+    cout << "后端对比: " << frames.size() - config.warmup << " 帧（预热 " << config.warmup << " 帧）" << endl;
+
+    int failures = 0;
+
+    if (!config.yoloBackends.empty()) {
+        vector<Timing> timings;
+        vector<vector<vector<Detection>>> reference;
+        for (const string& backend : config.yoloBackends) {
+            Timing timing;
+            timing.backend = backend;
+            vector<vector<vector<Detection>>> results;
+            try {
+                YOLOWrapper::Config backendConfig = yoloConfig;
+                backendConfig.backend = backend;
+                YOLOWrapper yolo(backendConfig);
+                if (!yolo.loaded()) {
+                    throw runtime_error("backend failed to load");
+                }
+                for (size_t i = 0; i < frames.size(); ++i) {
+                    vector<Mat> crops = cropROIs(frames[i], lightROIs);
+                    auto start = chrono::steady_clock::now();
+                    vector<vector<Detection>> detections = yolo.infer(crops);
+                    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                    if ((int)i < config.warmup) continue;
+                    timing.latencyMs.push_back(ms);
+                    results.push_back(std::move(detections));
+                }
+                timing.ok = true;
+            } catch (const std::exception& e) {
+                timing.error = e.what();
+                failures++;
+            }
+            if (timing.ok) {
+                if (reference.empty()) {
+                    reference = std::move(results);
+                } else {
+                    timing.agreement = detectionAgreement(reference, results);
+                }
+            }
+            timings.push_back(std::move(timing));
+        }
+        printTable("YOLO", timings);
+    }
+
+    if (!config.ocrBackends.empty()) {
+        vector<Timing> timings;
+        vector<vector<string>> reference;
+        for (const string& backend : config.ocrBackends) {
+            Timing timing;
+            timing.backend = backend;
+            vector<vector<string>> results;
+            try {
+                // 关闭结果缓存，每帧都实际推理
+                OCRWrapper::Config backendConfig = ocrConfig;
+                backendConfig.backend = backend;
+                backendConfig.cacheEnable = false;
+                OCRWrapper ocr(backendConfig);
+                if (!ocr.loaded()) {
+                    throw runtime_error("backend failed to load");
+                }
+                for (size_t i = 0; i < frames.size(); ++i) {
+                    vector<Mat> crops = cropROIs(frames[i], timerROIs);
+                    auto start = chrono::steady_clock::now();
+                    vector<string> texts = ocr.infer(crops);
+                    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                    if ((int)i < config.warmup) continue;
+                    timing.latencyMs.push_back(ms);
+                    results.push_back(std::move(texts));
+                }
+                timing.ok = true;
+            } catch (const std::exception& e) {
+                timing.error = e.what();
+                failures++;
+            }
+            if (timing.ok) {
+                if (reference.empty()) {
+                    reference = std::move(results);
+                } else {
+                    timing.agreement = textAgreement(reference, results);
+                }
+            }
+            timings.push_back(std::move(timing));
+        }
+        printTable("OCR", timings);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+#include "ctc_decoder.h"
+#include <opencv2/core/hal/intrin.hpp>
+
+CtcDecoder::CtcDecoder(const std::vector<std::string>& labels) : labels_(labels) {}
+
+void CtcDecoder::restrictCharset(const std::string& charset) {
+    columns_.clear();
+    if (charset.empty()) return;
+
+    columns_.push_back(0);  // blank
+    for (size_t i = 1; i < labels_.size(); ++i) {
+        if (labels_[i].size() == 1 && charset.find(labels_[i][0]) != std::string::npos) {
+            columns_.push_back((int)i);
+        }
+    }
+}
+
+int CtcDecoder::argmax(const float* row, int length, float& maxValue) {
+    int i = 0;
+    int bestIdx = 0;
+    float best = row[0];
+#if CV_SIMD128
+    if (length >= 8) {
+        // 每个 lane 记录自身的最大值及其下标，严格大于才更新以保留首次出现的位置
+        cv::v_float32x4 vbest = cv::v_load(row);
+        cv::v_int32x4 vbestIdx(0, 1, 2, 3);
+        cv::v_int32x4 vidx(4, 5, 6, 7);
+        const cv::v_int32x4 vstep = cv::v_setall_s32(4);
+        for (i = 4; i <= length - 4; i += 4) {
+            cv::v_float32x4 v = cv::v_load(row + i);
+            cv::v_float32x4 greater = v > vbest;
+            vbest = cv::v_select(greater, v, vbest);
+            vbestIdx = cv::v_select(cv::v_reinterpret_as_s32(greater), vidx, vbestIdx);
+            vidx = vidx + vstep;
+        }
+
+        float lanes[4];
+        int laneIdx[4];
+        cv::v_store(lanes, vbest);
+        cv::v_store(laneIdx, vbestIdx);
+        best = lanes[0];
+        bestIdx = laneIdx[0];
+        for (int k = 1; k < 4; ++k) {
+            if (lanes[k] > best || (lanes[k] == best && laneIdx[k] < bestIdx)) {
+                best = lanes[k];
+                bestIdx = laneIdx[k];
+            }
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        if (row[i] > best) {
+            best = row[i];
+            bestIdx = i;
+        }
+    }
+    maxValue = best;
+    return bestIdx;
+}
+
+void CtcDecoder::decode(const float* probs, int batchSize, int timeSteps, int numClasses,
+                        std::vector<CtcResult>& results) const {
+    results.clear();
+    results.reserve(batchSize);
+    for (int m = 0; m < batchSize; ++m) {
+        CtcResult result;
+        int lastIndex = 0;
+        float score = 0.0f;
+        int count = 0;
+
+        for (int n = 0; n < timeSteps; ++n) {
+            const float* row = probs + ((size_t)m * timeSteps + n) * numClasses;
+            int argmaxIdx = 0;
+            float maxValue = 0.0f;
+            if (columns_.empty()) {
+                argmaxIdx = argmax(row, numClasses, maxValue);
+            } else {
+                // 限定字符集：只看 blank 和候选字符所在的列
+                maxValue = row[columns_[0]];
+                argmaxIdx = columns_[0];
+                for (size_t k = 1; k < columns_.size(); ++k) {
+                    float v = row[columns_[k]];
+                    if (v > maxValue) {
+                        maxValue = v;
+                        argmaxIdx = columns_[k];
+                    }
+                }
+            }
+
+            // 跳过 blank 和连续重复的字符
+            if (argmaxIdx > 0 && !(n > 0 && argmaxIdx == lastIndex)) {
+                score += maxValue;
+                count += 1;
+                if (argmaxIdx < (int)labels_.size()) {
+                    result.text += labels_[argmaxIdx];
+                }
+            }
+            lastIndex = argmaxIdx;
+        }
+
+        result.score = count > 0 ? score / count : 0.0f;
+        results.push_back(std::move(result));
+    }
+}
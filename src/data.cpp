@@ -1,4 +1,5 @@
 #include "data.h"
+#include <opencv2/core/hal/intrin.hpp>
 
 // 定义颜色向量
 std::vector<cv::Scalar> data_utils::colors;
@@ -49,28 +50,77 @@ void data_utils::loadNames(const std::vector<std::string>& classNames)
 void data_utils::visualizeDetection(cv::Mat &im, std::vector<Detection> &results,
                                const std::vector<std::string> &classNames)
 {
-    cv::Mat image = im.clone();
-    for (const Detection &result : results)
+    // 半透明叠加只影响绘制到的像素，因此只对检测框及标签所在的区域做 clone 和 addWeighted，
+    // 而不是整帧。相互重叠的区域先合并，保证每个像素只混合一次
+    const int pad = 4;  // 线宽和文字笔画超出外接矩形的余量
+    const cv::Rect imageRect(0, 0, im.cols, im.rows);
+    std::vector<cv::Rect> regions;
+    std::vector<std::vector<size_t>> members;
+    for (size_t i = 0; i < results.size(); ++i)
     {
-        int x = result.box.x;
-        int y = result.box.y;
-
+        const Detection &result = results[i];
         int conf = (int)std::round(result.confidence * 100);
-        int classId = result.classId;
-        std::string label = classNames[classId] + " 0." + std::to_string(conf);
-
         int baseline = 0;
+        std::string label = classNames[result.classId] + " 0." + std::to_string(conf);
         cv::Size size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 1.2, 1.5, &baseline);
-        
-        cv::rectangle(image, result.box, colors[classId], 2);
-        cv::rectangle(image,
-                      cv::Point(x, y), cv::Point(x + size.width, y + 30),
-                      colors[classId], -1);
-        cv::putText(image, label,
-                    cv::Point(x, y - 3 + 25), cv::FONT_HERSHEY_SIMPLEX,
-                    1.0, cv::Scalar(0, 0, 0), 3);
+        cv::Rect extent = result.box | cv::Rect(result.box.x, result.box.y, size.width, 30);
+        extent = cv::Rect(extent.x - pad, extent.y - pad, extent.width + 2 * pad, extent.height + 2 * pad) & imageRect;
+        if (extent.area() <= 0)
+            continue;
+
+        regions.push_back(extent);
+        members.push_back({i});
+
+        // 与已有区域相交时合并，合并后可能又与其他区域相交，重复直到互不相交
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (size_t r = 0; r + 1 < regions.size(); ++r)
+            {
+                if ((regions[r] & regions.back()).area() > 0)
+                {
+                    regions[r] |= regions.back();
+                    members[r].insert(members[r].end(), members.back().begin(), members.back().end());
+                    regions.pop_back();
+                    members.pop_back();
+                    std::swap(regions[r], regions.back());
+                    std::swap(members[r], members.back());
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t r = 0; r < regions.size(); ++r)
+    {
+        const cv::Rect &region = regions[r];
+        cv::Mat target = im(region);
+        cv::Mat image = target.clone();
+        for (size_t i : members[r])
+        {
+            const Detection &result = results[i];
+            int x = result.box.x - region.x;
+            int y = result.box.y - region.y;
+
+            int conf = (int)std::round(result.confidence * 100);
+            int classId = result.classId;
+            std::string label = classNames[classId] + " 0." + std::to_string(conf);
+
+            int baseline = 0;
+            cv::Size size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 1.2, 1.5, &baseline);
+
+            cv::rectangle(image, cv::Rect(x, y, result.box.width, result.box.height), colors[classId], 2);
+            cv::rectangle(image,
+                          cv::Point(x, y), cv::Point(x + size.width, y + 30),
+                          colors[classId], -1);
+            cv::putText(image, label,
+                        cv::Point(x, y - 3 + 25), cv::FONT_HERSHEY_SIMPLEX,
+                        1.0, cv::Scalar(0, 0, 0), 3);
+        }
+        cv::addWeighted(target, 0.4, image, 0.6, 0, target);
     }
-    cv::addWeighted(im, 0.4, image, 0.6, 0, im);
 }
 
 void data_utils::letterbox(const cv::Mat &image, cv::Mat &outImage,
@@ -127,6 +177,104 @@ void data_utils::letterbox(const cv::Mat &image, cv::Mat &outImage,
     cv::copyMakeBorder(outImage, outImage, top, bottom, left, right, cv::BORDER_CONSTANT, color);
 }
 
+namespace {
+// 将一行 BGR 像素归一化后拆分写入 R/G/B 三个平面
+inline void bgrRowToPlanes(const uchar *src, int width, float scale,
+                           float *dstR, float *dstG, float *dstB)
+{
+    int x = 0;
+#if CV_SIMD128
+    const cv::v_float32x4 vscale = cv::v_setall_f32(scale);
+    auto storeScaled = [&vscale](const cv::v_uint8x16 &v, float *dst) {
+        cv::v_uint16x8 lo16, hi16;
+        cv::v_uint32x4 q0, q1, q2, q3;
+        cv::v_expand(v, lo16, hi16);
+        cv::v_expand(lo16, q0, q1);
+        cv::v_expand(hi16, q2, q3);
+        cv::v_store(dst, cv::v_cvt_f32(cv::v_reinterpret_as_s32(q0)) * vscale);
+        cv::v_store(dst + 4, cv::v_cvt_f32(cv::v_reinterpret_as_s32(q1)) * vscale);
+        cv::v_store(dst + 8, cv::v_cvt_f32(cv::v_reinterpret_as_s32(q2)) * vscale);
+        cv::v_store(dst + 12, cv::v_cvt_f32(cv::v_reinterpret_as_s32(q3)) * vscale);
+    };
+    for (; x <= width - 16; x += 16)
+    {
+        cv::v_uint8x16 b, g, r;
+        cv::v_load_deinterleave(src + x * 3, b, g, r);
+        storeScaled(r, dstR + x);
+        storeScaled(g, dstG + x);
+        storeScaled(b, dstB + x);
+    }
+#endif
+    for (; x < width; x++)
+    {
+        dstB[x] = src[x * 3] * scale;
+        dstG[x] = src[x * 3 + 1] * scale;
+        dstR[x] = src[x * 3 + 2] * scale;
+    }
+}
+}
+
+void data_utils::letterboxToBlob(const cv::Mat &image, float *blob,
+                                 const cv::Size &newShape,
+                                 const cv::Scalar &color,
+                                 cv::Mat &resizeBuffer)
+{
+    CV_Assert(image.type() == CV_8UC3);
+
+    // 与 letterbox(auto_=false, scaleFill=false, scaleUp=true) 保持一致的缩放与填充计算
+    cv::Size shape = image.size();
+    float r = std::min((float)newShape.height / (float)shape.height,
+                       (float)newShape.width / (float)shape.width);
+    cv::Size newUnpad((int)std::round((float)shape.width * r),
+                      (int)std::round((float)shape.height * r));
+    float dw = (float)(newShape.width - newUnpad.width) / 2.0f;
+    float dh = (float)(newShape.height - newUnpad.height) / 2.0f;
+    int top = int(std::round(dh - 0.1f));
+    int left = int(std::round(dw - 0.1f));
+
+    // 缩放写入复用的缓冲区，尺寸不变时不重新分配
+    const cv::Mat *resized = &image;
+    if (shape != newUnpad)
+    {
+        cv::resize(image, resizeBuffer, newUnpad);
+        resized = &resizeBuffer;
+    }
+
+    const float scale = 1.0f / 255.0f;
+    const int planeSize = newShape.area();
+    float *planeR = blob;
+    float *planeG = blob + planeSize;
+    float *planeB = blob + 2 * planeSize;
+    const float padR = (float)color[2] * scale;
+    const float padG = (float)color[1] * scale;
+    const float padB = (float)color[0] * scale;
+
+    for (int y = 0; y < newShape.height; y++)
+    {
+        float *rowR = planeR + y * newShape.width;
+        float *rowG = planeG + y * newShape.width;
+        float *rowB = planeB + y * newShape.width;
+        int srcY = y - top;
+        if (srcY < 0 || srcY >= newUnpad.height)
+        {
+            std::fill(rowR, rowR + newShape.width, padR);
+            std::fill(rowG, rowG + newShape.width, padG);
+            std::fill(rowB, rowB + newShape.width, padB);
+            continue;
+        }
+
+        int right = left + newUnpad.width;
+        std::fill(rowR, rowR + left, padR);
+        std::fill(rowG, rowG + left, padG);
+        std::fill(rowB, rowB + left, padB);
+        bgrRowToPlanes(resized->ptr<uchar>(srcY), newUnpad.width, scale,
+                       rowR + left, rowG + left, rowB + left);
+        std::fill(rowR + right, rowR + newShape.width, padR);
+        std::fill(rowG + right, rowG + newShape.width, padG);
+        std::fill(rowB + right, rowB + newShape.width, padB);
+    }
+}
+
 void data_utils::scaleCoords(cv::Rect &coords, const cv::Size &imageShape, const cv::Size &imageOriginalShape) {
     float gain = std::min((float)imageShape.height / (float)imageOriginalShape.height,
                           (float)imageShape.width / (float)imageOriginalShape.width);
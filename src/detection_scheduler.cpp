@@ -0,0 +1,145 @@
+#include "detection_scheduler.h"
+#include <algorithm>
+#include "nms.h"
+
+using namespace std;
+
+namespace {
+const int kThumbnailSize = 32;
+}
+
+void DetectionScheduler::computeThumbnail(const cv::Mat& frame, cv::Mat& thumbnail) {
+    cv::resize(frame, thumbnail, cv::Size(kThumbnailSize, kThumbnailSize), 0, 0, cv::INTER_AREA);
+    if (thumbnail.channels() == 3) {
+        cv::cvtColor(thumbnail, thumbnail, cv::COLOR_BGR2GRAY);
+    }
+}
+
+bool DetectionScheduler::shouldDetect(const cv::Mat& frame) {
+    if (!config_.enable || !hasKeyframe_) return true;
+
+    if (framesSinceKeyframe_ + 1 >= interval_) return true;
+
+    // 运动触发：与关键帧缩略图的平均灰度差
+    computeThumbnail(frame, thumbnail_);
+    cv::absdiff(thumbnail_, keyThumbnail_, diff_);
+    return cv::mean(diff_)[0] > config_.motionTrigger;
+}
+
+cv::Rect DetectionScheduler::predictBox(const Track& track, int frames) const {
+    cv::Point2f center(track.center.x + track.velocity.x * frames,
+                       track.center.y + track.velocity.y * frames);
+    return cv::Rect(cvRound(center.x - track.size.width / 2), cvRound(center.y - track.size.height / 2),
+                    cvRound(track.size.width), cvRound(track.size.height));
+}
+
+int DetectionScheduler::dominantColor(const cv::Mat& frame, const cv::Rect& box) {
+    cv::Rect roi = box & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (roi.area() <= 0) return -1;
+
+    // 只统计高饱和度、高亮度的像素，按色相归入红/黄/绿
+    cv::cvtColor(frame(roi), hsv_, cv::COLOR_BGR2HSV);
+    int red = 0, yellow = 0, green = 0;
+    for (int y = 0; y < hsv_.rows; y++) {
+        const uchar* p = hsv_.ptr<uchar>(y);
+        for (int x = 0; x < hsv_.cols; x++, p += 3) {
+            if (p[1] < 100 || p[2] < 150) continue;
+            int hue = p[0];
+            if (hue < 10 || hue > 160) red++;
+            else if (hue >= 15 && hue <= 35) yellow++;
+            else if (hue >= 40 && hue <= 95) green++;
+        }
+    }
+
+    // 亮灯像素太少视为未亮
+    int minLit = std::max(4, roi.area() / 50);
+    int best = std::max(red, std::max(yellow, green));
+    if (best < minLit) return -1;
+    if (best == red) return config_.redClassId;
+    if (best == yellow) return config_.yellowClassId;
+    return config_.greenClassId;
+}
+
+bool DetectionScheduler::track(const cv::Mat& frame, std::vector<Detection>& detections) {
+    // 校验失败时当前帧随即作为关键帧由 update 计入，这里只在跟踪成功后才累加帧数
+    int frames = framesSinceKeyframe_ + 1;
+    detections.clear();
+    for (const Track& t : tracks_) {
+        Detection det = t.detection;
+        det.box = predictBox(t, frames);
+
+        // 颜色校验：框内亮灯颜色与关键帧时不一致，说明状态可能已变化
+        if (config_.colorCheck && dominantColor(frame, det.box) != t.litColor) {
+            return false;
+        }
+        detections.push_back(det);
+    }
+    framesSinceKeyframe_ = frames;
+    trackedFrames_++;
+    return true;
+}
+
+void DetectionScheduler::update(const cv::Mat& frame, const std::vector<Detection>& detections) {
+    keyframes_++;
+    int elapsed = hasKeyframe_ ? framesSinceKeyframe_ + 1 : 0;
+
+    // 按 IoU 贪心匹配上一关键帧的跟踪框；灯箱颜色会变化，匹配时不区分类别
+    vector<Track> updated;
+    vector<bool> used(tracks_.size(), false);
+    // 没有检测到灯时不算稳定，保持最小间隔，灯重新出现时能及时检出
+    bool stable = hasKeyframe_ && !detections.empty() && detections.size() == tracks_.size();
+    for (const Detection& det : detections) {
+        int bestIdx = -1;
+        float bestIou = 0.0f;
+        for (size_t i = 0; i < tracks_.size(); i++) {
+            if (used[i]) continue;
+            float overlap = nms_utils::iou(predictBox(tracks_[i], elapsed), det.box);
+            if (overlap > bestIou) {
+                bestIou = overlap;
+                bestIdx = (int)i;
+            }
+        }
+
+        Track t;
+        t.detection = det;
+        cv::Point2f measured(det.box.x + det.box.width / 2.0f, det.box.y + det.box.height / 2.0f);
+        cv::Size2f measuredSize((float)det.box.width, (float)det.box.height);
+        if (bestIdx >= 0 && bestIou > 0.0f) {
+            // alpha-beta 滤波平滑位置并估计每帧速度
+            const Track& prev = tracks_[bestIdx];
+            used[bestIdx] = true;
+            int frames = std::max(elapsed, 1);
+            cv::Point2f predicted(prev.center.x + prev.velocity.x * frames,
+                                  prev.center.y + prev.velocity.y * frames);
+            cv::Point2f residual(measured.x - predicted.x, measured.y - predicted.y);
+            t.center = cv::Point2f(predicted.x + config_.alpha * residual.x,
+                                   predicted.y + config_.alpha * residual.y);
+            t.velocity = cv::Point2f(prev.velocity.x + config_.beta * residual.x / frames,
+                                     prev.velocity.y + config_.beta * residual.y / frames);
+            t.size = cv::Size2f(prev.size.width + config_.alpha * (measuredSize.width - prev.size.width),
+                                prev.size.height + config_.alpha * (measuredSize.height - prev.size.height));
+            stable = stable && bestIou >= config_.stableIou && prev.detection.classId == det.classId;
+        } else {
+            t.center = measured;
+            t.velocity = cv::Point2f(0.0f, 0.0f);
+            t.size = measuredSize;
+            stable = false;
+        }
+        t.detection.box = predictBox(t, 0);
+        t.litColor = config_.colorCheck ? dominantColor(frame, det.box) : -1;
+        if (det.confidence < config_.confTrigger) stable = false;
+        updated.push_back(t);
+    }
+    tracks_ = std::move(updated);
+
+    // 稳定则关键帧间隔翻倍，否则回到最短间隔
+    interval_ = stable ? std::min(interval_ * 2, config_.maxInterval) : config_.minInterval;
+    bool lowConfidence = std::any_of(tracks_.begin(), tracks_.end(), [this](const Track& t) {
+        return t.detection.confidence < config_.confTrigger;
+    });
+    if (lowConfidence) interval_ = config_.minInterval;
+
+    computeThumbnail(frame, keyThumbnail_);
+    framesSinceKeyframe_ = 0;
+    hasKeyframe_ = true;
+}
@@ -0,0 +1,64 @@
+#include "frame_dumper.h"
+#include <iostream>
+#include <sys/stat.h>
+#include <cerrno>
+
+using namespace cv;
+using namespace std;
+
+FrameDumper::FrameDumper(const Config& config)
+    : config_(config), queue_(config.queueCapacity) {
+    if (!config_.enable) return;
+
+    if (mkdir(config_.outputDir.c_str(), 0777) != 0 && errno != EEXIST) {
+        cerr << "Error: Could not create output directory " << config_.outputDir << endl;
+        config_.enable = false;
+        return;
+    }
+    thread_ = thread(&FrameDumper::writeLoop, this);
+}
+
+FrameDumper::~FrameDumper() {
+    stop();
+}
+
+void FrameDumper::stop() {
+    queue_.close();
+    if (thread_.joinable()) thread_.join();
+}
+
+bool FrameDumper::wanted(int64_t index, bool transition, bool anomaly) const {
+    if (!config_.enable) return false;
+    if (config_.sampleInterval > 0 && index % config_.sampleInterval == 0) return true;
+    if (config_.onTransition && transition) return true;
+    return config_.onAnomaly && anomaly;
+}
+
+bool FrameDumper::submit(const Mat& frame, const string& fileName) {
+    if (!config_.enable) return false;
+    if (!queue_.tryPush(Job{frame, config_.outputDir + "/" + fileName})) {
+        dropped_++;
+        return false;
+    }
+    return true;
+}
+
+void FrameDumper::writeLoop() {
+    const vector<int> params = {IMWRITE_JPEG_QUALITY, config_.jpegQuality};
+    Job job;
+    // 关闭后仍会写完队列中剩余的帧
+    while (queue_.pop(job)) {
+        bool ok = false;
+        try {
+            ok = imwrite(job.path, job.frame, params);
+        } catch (const cv::Exception& e) {
+            cerr << "调试帧写入失败: " << e.what() << endl;
+        }
+        if (ok) {
+            written_++;
+        } else {
+            failed_++;
+        }
+        job.frame.release();
+    }
+}
@@ -0,0 +1,86 @@
+#include "frame_grabber.h"
+#include <algorithm>
+#include "metrics.h"
+
+using namespace cv;
+using namespace std;
+
+FrameGrabber::FrameGrabber(VideoCapture& cap, int ringSize)
+    : cap_(cap), ring_(max(2, ringSize)), slots_(ring_.size()) {}
+
+FrameGrabber::~FrameGrabber() {
+    stop();
+}
+
+void FrameGrabber::start() {
+    if (thread_.joinable()) return;
+    stopRequested_ = false;
+    thread_ = thread(&FrameGrabber::grabLoop, this);
+}
+
+// 可能同时被采集线程和流水线的 stop 调用
+void FrameGrabber::stop() {
+    stopRequested_ = true;
+    {
+        lock_guard<mutex> lock(mutex_);
+        finished_ = true;
+    }
+    frameReady_.notify_all();
+
+    lock_guard<mutex> lock(joinMutex_);
+    if (thread_.joinable()) thread_.join();
+}
+
+void FrameGrabber::grabLoop() {
+    int writeSlot = 0;
+    int64_t sequence = 0;
+    while (!stopRequested_) {
+        // 槽位仍被下游持有时（引用计数大于 1）放弃该缓冲区，由 read 重新分配，
+        // 否则复用预分配的内存，避免覆盖尚在处理中的帧；
+        // 引用计数由其他线程原子递减，用 CV_XADD 原子读取
+        Mat& slot = ring_[writeSlot];
+        if (slot.u && CV_XADD(&slot.u->refcount, 0) > 1) {
+            slot.release();
+        }
+        {
+            METRICS_SCOPE("decode");
+            if (!cap_.read(slot) || slot.empty()) break;
+        }
+
+        Frame& info = slots_[writeSlot];
+        info.sequence = ++sequence;
+        info.posMsec = cap_.get(CAP_PROP_POS_MSEC);
+        info.grabTime = chrono::steady_clock::now();
+        grabbed_++;
+
+        {
+            lock_guard<mutex> lock(mutex_);
+            // 上一帧尚未被取走即被覆盖
+            if (latestSequence_ > consumedSequence_) {
+                dropped_++;
+            }
+            latest_ = writeSlot;
+            latestSequence_ = sequence;
+        }
+        frameReady_.notify_one();
+
+        // 下一个写入槽位总是不同于最新帧所在的槽位，read 取帧时该槽位不会被写入
+        writeSlot = (writeSlot + 1) % (int)ring_.size();
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    finished_ = true;
+    frameReady_.notify_all();
+}
+
+bool FrameGrabber::read(Frame& out) {
+    unique_lock<mutex> lock(mutex_);
+    frameReady_.wait(lock, [this] { return latestSequence_ > consumedSequence_ || finished_; });
+    if (latestSequence_ <= consumedSequence_) return false;
+
+    // 共享槽位数据（只增加引用计数），写线程发现引用计数大于 1 时不会复用该缓冲区
+    out = slots_[latest_];
+    out.frame = ring_[latest_];
+    consumedSequence_ = latestSequence_;
+    return true;
+}
@@ -0,0 +1,26 @@
+#include "inference_backend.h"
+#include "ort_backend.h"
+#include "paddle_backend.h"
+#include "opencv_dnn_backend.h"
+
+using namespace std;
+
+unique_ptr<InferenceBackend> createInferenceBackend(const string& name,
+                                                    const string& modelPath,
+                                                    int numThreads,
+                                                    const vector<int64_t>& inputShape) {
+    if (name == "onnxruntime") {
+        return unique_ptr<InferenceBackend>(new OrtBackend(modelPath, numThreads));
+    }
+    if (name == "opencv_dnn") {
+        return unique_ptr<InferenceBackend>(new OpenCvDnnBackend(modelPath, inputShape));
+    }
+    if (name == "paddle" || name == "paddle_openvino") {
+        PaddleBackend::Options options;
+        options.numThreads = numThreads;
+        options.imgH = inputShape.size() > 2 ? (int)inputShape[2] : options.imgH;
+        options.openvino = name == "paddle_openvino";
+        return unique_ptr<InferenceBackend>(new PaddleBackend(modelPath, options));
+    }
+    return nullptr;
+}
@@ -0,0 +1,49 @@
+#include "logger.h"
+#include <chrono>
+#include <ctime>
+#include <iostream>
+
+using namespace std;
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+LogLevel Logger::parseLevel(const string& name) {
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "warn") return LogLevel::Warn;
+    if (name == "error") return LogLevel::Error;
+    if (name == "off") return LogLevel::Off;
+    return LogLevel::Info;
+}
+
+bool Logger::start(const Config& config) {
+    level_ = parseLevel(config.level);
+    return writer_.start(config.file, config.ringCapacity, config.flushIntervalMs);
+}
+
+void Logger::stop() {
+    writer_.stop();
+}
+
+void Logger::write(LogLevel level, const string& message) {
+    static const char* const tags[] = {"D", "I", "W", "E", "-"};
+
+    // 时间戳在调用线程生成，反映事件发生的时刻
+    auto now = chrono::system_clock::now();
+    time_t seconds = chrono::system_clock::to_time_t(now);
+    int millis = (int)(chrono::duration_cast<chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+    tm local;
+    localtime_r(&seconds, &local);
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "[%02d:%02d:%02d.%03d][%s] ",
+             local.tm_hour, local.tm_min, local.tm_sec, millis, tags[(int)level]);
+
+    string line = prefix + message;
+    if (!writer_.started()) {
+        cout << line << endl;
+        return;
+    }
+    writer_.write(line);
+}
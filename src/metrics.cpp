@@ -0,0 +1,261 @@
+#include "metrics.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+int LatencyHistogram::bucketOf(uint64_t us) {
+    // [0, 8) 直接落在首个区间，此后每个 2 的幂区间 [2^e, 2^(e+1)) 按最高 3 位以下的位等分
+    if (us < (uint64_t)kSubBuckets) return (int)us;
+    int exponent = 63 - __builtin_clzll(us);
+    int sub = (int)((us >> (exponent - kSubBits)) & (kSubBuckets - 1));
+    int bucket = (exponent - kSubBits + 1) * kSubBuckets + sub;
+    return bucket < kBuckets ? bucket : kBuckets - 1;
+}
+
+double LatencyHistogram::bucketMidUs(int bucket) {
+    if (bucket < kSubBuckets) return bucket + 0.5;
+    int exponent = bucket / kSubBuckets + kSubBits - 1;
+    int sub = bucket % kSubBuckets;
+    double width = (double)(1ULL << (exponent - kSubBits));
+    return (double)(1ULL << exponent) + (sub + 0.5) * width;
+}
+
+LatencyHistogram::LatencyHistogram() : id_([] {
+    static atomic<uint64_t> nextId{0};
+    return ++nextId;
+}()) {}
+
+LatencyHistogram::Shard& LatencyHistogram::localShard() {
+    // 每个线程缓存自己在各直方图中的分片，直方图数量很少，线性查找即可
+    thread_local vector<pair<uint64_t, Shard*>> cache;
+    for (const auto& item : cache) {
+        if (item.first == id_) return *item.second;
+    }
+    Shard* shard = new Shard();
+    {
+        lock_guard<mutex> lock(mutex_);
+        shards_.emplace_back(shard);
+    }
+    cache.emplace_back(id_, shard);
+    return *shard;
+}
+
+void LatencyHistogram::record(int64_t us) {
+    if (us < 0) us = 0;
+    // 分片只有本线程写入，读-改-写无需原子指令
+    Shard& shard = localShard();
+    atomic<uint64_t>& bucket = shard.buckets[bucketOf((uint64_t)us)];
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    shard.count.store(shard.count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    shard.sumUs.store(shard.sumUs.load(memory_order_relaxed) + (uint64_t)us, memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    lock_guard<mutex> lock(mutex_);
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard->count.load(memory_order_relaxed);
+    return total;
+}
+
+double LatencyHistogram::sumSeconds() const {
+    lock_guard<mutex> lock(mutex_);
+    uint64_t sumUs = 0;
+    for (const auto& shard : shards_) sumUs += shard->sumUs.load(memory_order_relaxed);
+    return sumUs / 1e6;
+}
+
+double LatencyHistogram::quantileUs(double q) const {
+    // 先合并各分片的桶，总数也取自合并结果，避免与并发写入的 count 不一致
+    uint64_t merged[kBuckets] = {};
+    uint64_t total = 0;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (const auto& shard : shards_) {
+            for (int i = 0; i < kBuckets; ++i) {
+                merged[i] += shard->buckets[i].load(memory_order_relaxed);
+            }
+        }
+    }
+    for (int i = 0; i < kBuckets; ++i) total += merged[i];
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += merged[i];
+        if (seen >= rank) return bucketMidUs(i);
+    }
+    return bucketMidUs(kBuckets - 1);
+}
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::~Metrics() {
+    stop();
+}
+
+void Metrics::start(const Config& config) {
+    config_ = config;
+    enabled_ = config_.enable;
+    if (!enabled_) return;
+
+    if (config_.httpPort > 0) {
+        listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)config_.httpPort);
+        inet_pton(AF_INET, config_.bindAddress.c_str(), &addr.sin_addr);
+        if (listenFd_ < 0 || ::bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd_, 4) != 0) {
+            cerr << "Error: metrics endpoint could not listen on " << config_.bindAddress << ":" << config_.httpPort << endl;
+            if (listenFd_ >= 0) close(listenFd_);
+            listenFd_ = -1;
+        } else {
+            cout << "指标导出: http://" << config_.bindAddress << ":" << config_.httpPort << "/metrics" << endl;
+        }
+    }
+    if (listenFd_ >= 0 || !config_.file.empty()) {
+        stopRequested_ = false;
+        thread_ = thread(&Metrics::serveLoop, this);
+    }
+}
+
+void Metrics::stop() {
+    stopRequested_ = true;
+    if (thread_.joinable()) thread_.join();
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+    // 退出前写一次最终结果
+    if (enabled_ && !config_.file.empty()) {
+        writeFile(render());
+    }
+}
+
+LatencyHistogram* Metrics::histogram(const string& stage) {
+    if (!enabled_) return nullptr;
+    lock_guard<mutex> lock(mutex_);
+    unique_ptr<LatencyHistogram>& histogram = histograms_[stage];
+    if (!histogram) histogram.reset(new LatencyHistogram());
+    return histogram.get();
+}
+
+LatencyHistogram* Metrics::histogram(atomic<LatencyHistogram*>& cache, const char* stage) {
+    LatencyHistogram* cached = cache.load(memory_order_acquire);
+    if (cached || !enabled_) return cached;
+    LatencyHistogram* found = histogram(stage);
+    cache.store(found, memory_order_release);
+    return found;
+}
+
+int Metrics::addCallback(const string& name, const string& labels,
+                         const string& type, function<double()> sample) {
+    lock_guard<mutex> lock(mutex_);
+    int id = nextCallbackId_++;
+    callbacks_[id] = Callback{name, labels, type, std::move(sample)};
+    return id;
+}
+
+void Metrics::removeCallback(int id) {
+    lock_guard<mutex> lock(mutex_);
+    callbacks_.erase(id);
+}
+
+string Metrics::render() {
+    lock_guard<mutex> lock(mutex_);
+    ostringstream out;
+
+    out << "# HELP tld_stage_latency_seconds Per-stage latency.\n";
+    out << "# TYPE tld_stage_latency_seconds summary\n";
+    for (const auto& item : histograms_) {
+        const LatencyHistogram& histogram = *item.second;
+        for (double q : {0.5, 0.9, 0.99}) {
+            out << "tld_stage_latency_seconds{stage=\"" << item.first << "\",quantile=\"" << q << "\"} "
+                << histogram.quantileUs(q) / 1e6 << "\n";
+        }
+        out << "tld_stage_latency_seconds_sum{stage=\"" << item.first << "\"} " << histogram.sumSeconds() << "\n";
+        out << "tld_stage_latency_seconds_count{stage=\"" << item.first << "\"} " << histogram.count() << "\n";
+    }
+
+    // 同名指标只输出一次 TYPE 行
+    map<string, vector<const Callback*>> byName;
+    for (const auto& item : callbacks_) {
+        byName[item.second.name].push_back(&item.second);
+    }
+    for (const auto& item : byName) {
+        out << "# TYPE " << item.first << " " << item.second.front()->type << "\n";
+        for (const Callback* callback : item.second) {
+            out << item.first;
+            if (!callback->labels.empty()) out << "{" << callback->labels << "}";
+            out << " " << callback->sample() << "\n";
+        }
+    }
+    return out.str();
+}
+
+void Metrics::writeFile(const string& text) {
+    // 先写临时文件再改名，读取方不会看到写了一半的内容
+    string tmpPath = config_.file + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "w");
+    if (!file) return;
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+    rename(tmpPath.c_str(), config_.file.c_str());
+}
+
+void Metrics::serveLoop() {
+    auto lastWrite = chrono::steady_clock::now();
+    while (!stopRequested_) {
+        if (listenFd_ >= 0) {
+            pollfd pfd{listenFd_, POLLIN, 0};
+            if (poll(&pfd, 1, 200) > 0 && (pfd.revents & POLLIN)) {
+                int client = accept(listenFd_, nullptr, nullptr);
+                if (client >= 0) {
+                    // 收发都设超时：连接后不发请求或不读响应的客户端不能卡住导出线程（stop 需要 join）
+                    timeval timeout{1, 0};
+                    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                    // 任意路径都返回指标，请求内容只读取不解析
+                    char request[1024];
+                    ssize_t ignored = recv(client, request, sizeof(request), 0);
+                    (void)ignored;
+                    string body = render();
+                    ostringstream response;
+                    response << "HTTP/1.1 200 OK\r\n"
+                             << "Content-Type: text/plain; version=0.0.4\r\n"
+                             << "Content-Length: " << body.size() << "\r\n"
+                             << "Connection: close\r\n\r\n"
+                             << body;
+                    string data = response.str();
+                    size_t sent = 0;
+                    while (sent < data.size()) {
+                        ssize_t n = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                        if (n <= 0) break;
+                        sent += (size_t)n;
+                    }
+                    close(client);
+                }
+            }
+        } else {
+            this_thread::sleep_for(chrono::milliseconds(200));
+        }
+
+        if (!config_.file.empty() &&
+            chrono::steady_clock::now() - lastWrite >= chrono::milliseconds(config_.fileIntervalMs)) {
+            writeFile(render());
+            lastWrite = chrono::steady_clock::now();
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "nms.h"
+#include <algorithm>
+
+namespace nms_utils {
+
+float iou(const cv::Rect& a, const cv::Rect& b) {
+    int x1 = std::max(a.x, b.x);
+    int y1 = std::max(a.y, b.y);
+    int x2 = std::min(a.x + a.width, b.x + b.width);
+    int y2 = std::min(a.y + a.height, b.y + b.height);
+    if (x2 <= x1 || y2 <= y1) return 0.0f;
+
+    float inter = (float)(x2 - x1) * (float)(y2 - y1);
+    float unionArea = (float)a.area() + (float)b.area() - inter;
+    return unionArea > 0.0f ? inter / unionArea : 0.0f;
+}
+
+void nms(std::vector<Detection>& detections, const Options& options) {
+    auto byConfidence = [](const Detection& a, const Detection& b) {
+        return a.confidence > b.confidence;
+    };
+
+    // 只对置信度最高的 topK 个候选排序，其余直接丢弃
+    if (options.topK > 0 && detections.size() > (size_t)options.topK) {
+        std::partial_sort(detections.begin(), detections.begin() + options.topK,
+                          detections.end(), byConfidence);
+        detections.resize(options.topK);
+    } else {
+        std::sort(detections.begin(), detections.end(), byConfidence);
+    }
+
+    // 保留的框压缩到 detections 前部，后续候选只需与已保留的框比较
+    size_t kept = 0;
+    size_t maxKept = options.maxDetections > 0 ? (size_t)options.maxDetections : detections.size();
+    for (size_t i = 0; i < detections.size() && kept < maxKept; i++) {
+        const Detection& candidate = detections[i];
+        bool suppressed = false;
+        for (size_t k = 0; k < kept; k++) {
+            if (!options.classAgnostic && detections[k].classId != candidate.classId) continue;
+            if (iou(detections[k].box, candidate.box) > options.iouThreshold) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed) {
+            if (kept != i) detections[kept] = candidate;
+            kept++;
+        }
+    }
+    detections.resize(kept);
+}
+
+void batchedNms(std::vector<std::vector<Detection>>& batch, const Options& options, size_t first) {
+    for (size_t i = first; i < batch.size(); i++) {
+        nms(batch[i], options);
+    }
+}
+
+}
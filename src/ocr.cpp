@@ -1,5 +1,4 @@
 #include "ocr.h"
-#include "paddle_inference_api.h"
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <string>
@@ -7,151 +6,345 @@
 #include <algorithm>
 #include <numeric>
 #include <chrono>
+#include <stdexcept>
 #include "utils.h"
+#include "logger.h"
+#include "metrics.h"
+#include "paddle_backend.h"
+#include "quantization.h"
 
-using namespace paddle_infer;
 using namespace std;
 
 OCRWrapper::OCRWrapper(const Config& config) : config_(config) {
-    try {
-        // 初始化配置
-        paddle_infer::Config paddleConfig;
-        paddleConfig.SetModel(config.modelPath + "/inference.pdmodel", 
-                             config.modelPath + "/inference.pdiparams");
-        paddleConfig.EnableMKLDNN();  // 启用 MKLDNN 加速
-        paddleConfig.SetCpuMathLibraryNumThreads(config.intraOpNumThreads);
-        paddleConfig.EnableMemoryOptim();  // 启用内存优化
-
-        // 创建推理器
-        predictor_ = paddle_infer::CreatePredictor(paddleConfig);
-        if (!predictor_) {
-            throw runtime_error("Failed to create predictor");
+    // 加载字典
+    if (config.backend == "stub" && config.dictPath.empty()) {
+        // 桩后端未配置字典时以限定字符集（默认数字）作为字典
+        std::string chars = config.charset.empty() ? "0123456789" : config.charset;
+        for (char c : chars) {
+            labelList_.emplace_back(1, c);
         }
-    } catch (const std::exception& e) {
-        cerr << "OCR初始化失败: " << e.what() << endl;
-        predictor_ = nullptr;
+    } else {
+        labelList_ = ReadDict(config.dictPath);
     }
-
-    // 初始化其他成员变量
-    labelList_ = ReadDict(config.dictPath);
     labelList_.emplace(labelList_.begin(), "#"); // blank char for ctc
     labelList_.emplace_back(" ");
+    decoder_ = CtcDecoder(labelList_);
+    decoder_.restrictCharset(config.charset);
     recImageShape_ = {3, config.recImgH, config.recImgW};
+
+    if (config.backend == "stub") {
+        // 桩后端：输出 [N, rec_img_w/8, C]，每张图像都识别为 stub.text
+        int timeSteps = std::max(1, config.recImgW / 8);
+        backend_.reset(new StubBackend(config.stub, {-1, 3, config.recImgH, -1},
+                                       {timeSteps, (int64_t)labelList_.size()},
+                                       StubBackend::ctcProbabilities(labelList_, config.stub.text, timeSteps)));
+    } else {
+        // paddle 系列后端直接构造以传入 MKLDNN 与精度选项，其余后端加载 paddle2onnx 导出的模型
+        bool paddle = config.backend == "paddle" || config.backend == "paddle_openvino";
+        if (!paddle) {
+            backend_ = createInferenceBackend(config.backend, config.onnxModelPath,
+                                              config.intraOpNumThreads, {-1, 3, config.recImgH, -1});
+            if (!backend_) {
+                throw std::invalid_argument("unknown OCR backend: " + config.backend);
+            }
+        } else {
+            PaddleBackend::Options options;
+            options.numThreads = config.intraOpNumThreads;
+            options.imgH = config.recImgH;
+            options.useMkldnn = config.useMkldnn;
+            options.openvino = config.backend == "paddle_openvino";
+            options.precision = config.precision;
+            std::string modelDir = config.modelPath;
+            // int8ModelDir 为空时 modelPath 本身即为量化模型，不做精度检查
+            if (config.precision == "int8" && !config.int8ModelDir.empty()) {
+                modelDir = quantization::selectModel(config.modelPath, config.int8ModelDir,
+                                                     config.int8ReportPath, config.int8MinAgreement);
+                if (modelDir != config.int8ModelDir) {
+                    options.precision = "fp32";
+                }
+            }
+            PaddleBackend* paddleBackend = new PaddleBackend(modelDir, options);
+            backend_.reset(paddleBackend);
+            precision_ = paddleBackend->precision();
+            LOG_INFO("OCR 推理精度: " << precision_);
+        }
+    }
+    // 固定 batch 的后端（如 opencv_dnn）按其 batch 分批
+    int64_t backendBatch = backend_->inputShape()[0];
+    maxBatch_ = backendBatch > 0 ? (int)backendBatch : 0;
+
+    std::sort(config_.bucketWidths.begin(), config_.bucketWidths.end());
+    std::sort(config_.bucketBatchSizes.begin(), config_.bucketBatchSizes.end());
+    if (config_.bucketEnable && config_.bucketWarmup) {
+        warmup();
+    }
 }
 
 OCRWrapper::~OCRWrapper() {
     // 清理资源
 }
 
-void OCRWrapper::preprocess(const std::vector<cv::Mat>& img_list, std::vector<cv::Mat>& norm_img_batch, int& batch_width) {
-    size_t img_num = img_list.size();
-    std::vector<float> width_list;
-    for (size_t i = 0; i < img_num; ++i) {
-        width_list.emplace_back(float(img_list[i].cols) / img_list[i].rows);
+namespace {
+
+// 不小于 value 的最小档位，没有满足的档位时保持原值
+int selectBucket(const std::vector<int>& buckets, int value) {
+    for (int bucket : buckets) {
+        if (bucket >= value) {
+            return bucket;
+        }
     }
-    std::vector<size_t> indices = std::move(argsort(width_list));
+    return value;
+}
 
+} // namespace
+
+void OCRWrapper::preprocess(const std::vector<cv::Mat>& img_list, const std::vector<size_t>& indices,
+                            size_t begin, size_t end, int& batch_num, int& batch_width) {
     int imgH = this->recImageShape_[1];
     int imgW = this->recImageShape_[2];
     float max_wh_ratio = imgW * 1.0 / imgH;
-    for (size_t ino = 0; ino < img_num; ++ino) {
+    for (size_t ino = begin; ino < end; ++ino) {
         int h = img_list[indices[ino]].rows;
         int w = img_list[indices[ino]].cols;
         float wh_ratio = w * 1.0 / h;
         max_wh_ratio = std::max(max_wh_ratio, wh_ratio);
     }
+    batch_num = int(end - begin);
+    batch_width = std::max(int(imgH * max_wh_ratio), imgW);
+    if (config_.bucketEnable) {
+        int bucket = selectBucket(config_.bucketBatchSizes, batch_num);
+        batch_num = maxBatch_ > 0 && bucket > maxBatch_ ? batch_num : bucket;
+        batch_width = selectBucket(config_.bucketWidths, batch_width);
+    }
+
+    // 缩放、归一化、补齐和 CHW 排布一次完成，直接写入后端常驻的批量输入缓冲区
+    size_t image_size = (size_t)3 * imgH * batch_width;
+    float* input = backend_->prepareInput({batch_num, 3, imgH, batch_width});
+    for (size_t ino = begin; ino < end; ++ino) {
+        this->resizeNormPermuteOp_.Run(img_list[indices[ino]], input + (ino - begin) * image_size,
+                                       imgH, batch_width, this->mean_, this->scale_,
+                                       this->isScale_, resizeBuffer_);
+    }
+    fillBlank(input, int(end - begin), batch_num, batch_width);
+}
+
+void OCRWrapper::fillBlank(float* input, int begin, int end, int batch_width) {
+    size_t plane = (size_t)this->recImageShape_[1] * batch_width;
+    for (int i = begin; i < end; ++i) {
+        float* data = input + (size_t)i * 3 * plane;
+        for (int c = 0; c < 3; ++c) {
+            std::fill(data + c * plane, data + (c + 1) * plane, -this->mean_[c] * this->scale_[c]);
+        }
+    }
+}
+
+std::vector<float> OCRWrapper::preprocessSingle(const cv::Mat& img, int& width) {
+    int imgH = this->recImageShape_[1];
+    int imgW = this->recImageShape_[2];
+    float wh_ratio = img.cols * 1.0 / img.rows;
+    width = std::max(int(imgH * std::max(wh_ratio, imgW * 1.0f / imgH)), imgW);
+    if (config_.bucketEnable) {
+        width = selectBucket(config_.bucketWidths, width);
+    }
+    std::vector<float> blob((size_t)3 * imgH * width);
+    this->resizeNormPermuteOp_.Run(img, blob.data(), imgH, width, this->mean_, this->scale_,
+                                   this->isScale_, resizeBuffer_);
+    return blob;
+}
 
-    batch_width = imgW;
-    for (size_t ino = 0; ino < img_num; ++ino) {
-        cv::Mat srcimg;
-        img_list[indices[ino]].copyTo(srcimg);
-        cv::Mat resize_img;
-        this->resizeOp_.Run(srcimg, resize_img, max_wh_ratio,
-                             false, this->recImageShape_);
-        this->normalizeOp_.Run(resize_img, this->mean_, this->scale_,
-                                this->isScale_);
-        batch_width = std::max(resize_img.cols, batch_width);
-        norm_img_batch.emplace_back(std::move(resize_img));
+void OCRWrapper::warmup() {
+    auto start = chrono::steady_clock::now();
+    int shapes = 0;
+    for (int width : config_.bucketWidths) {
+        for (int batch : config_.bucketBatchSizes) {
+            if (maxBatch_ > 0 && batch > maxBatch_) continue;
+            float* input = backend_->prepareInput({batch, 3, this->recImageShape_[1], width});
+            fillBlank(input, 0, batch, width);
+            std::vector<int> predict_shape;
+            if (!run(predict_shape)) {
+                return;
+            }
+            ++shapes;
+        }
     }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    cout << "OCR预热完成: " << shapes << " 个输入形状, 耗时 " << elapsed << " ms" << endl;
 }
 
 std::vector<float> OCRWrapper::infer(const std::vector<cv::Mat>& norm_img_batch, int batch_width, std::vector<int>& predict_shape) {
     int batch_num = norm_img_batch.size();
-    std::vector<float> input(batch_num * 3 * this->recImageShape_[1] * batch_width, 0.0f);
-    this->permuteOp_.Run(norm_img_batch, input.data());
-
-    auto input_names = this->predictor_->GetInputNames();
-    auto input_t = this->predictor_->GetInputHandle(input_names[0]);
-    input_t->Reshape(std::vector<int>{batch_num, 3, this->recImageShape_[1], batch_width});
-    input_t->CopyFromCpu(input.data());
-
-    try {
-        this->predictor_->Run();
-    } catch (const std::exception& e) {
-        cerr << "OCR推理失败: " << e.what() << endl;
+    size_t input_size = (size_t)batch_num * 3 * this->recImageShape_[1] * batch_width;
+    float* input = backend_->prepareInput({batch_num, 3, this->recImageShape_[1], batch_width});
+    std::fill(input, input + input_size, 0.0f);
+    this->permuteOp_.Run(norm_img_batch, input);
+
+    const float* output = run(predict_shape);
+    if (!output) {
         return {};
     }
-
-    std::vector<float> predict_batch;
-    auto output_names = this->predictor_->GetOutputNames();
-    auto output_t = this->predictor_->GetOutputHandle(output_names[0]);
-    predict_shape = output_t->shape();
-
     size_t out_num = std::accumulate(predict_shape.begin(), predict_shape.end(),
                                      1, std::multiplies<int>());
-    predict_batch.resize(out_num);
-    output_t->CopyToCpu(predict_batch.data());
-    
-    return predict_batch;
+    return std::vector<float>(output, output + out_num);
 }
 
-std::vector<std::string> OCRWrapper::postprocess(const std::vector<float>& predict_batch, const std::vector<int>& predict_shape) {
-    std::vector<std::string> results;
+const float* OCRWrapper::run(std::vector<int>& predict_shape) {
+    std::vector<int64_t> output_shape;
+    const float* output = backend_->run(output_shape);
+    predict_shape.assign(output_shape.begin(), output_shape.end());
+    return output;
+}
+
+std::vector<CtcResult> OCRWrapper::postprocess(const float* predict_batch, const std::vector<int>& predict_shape) {
+    std::vector<CtcResult> results;
+    if (predict_shape.size() < 3) {
+        return results;
+    }
     int batch_size = predict_shape[0];
     int imgW = predict_shape[1];
     int num_classes = predict_shape[2];  // 类别数，即 labelList_.size()
-    for (int m = 0; m < batch_size; ++m) {
-        std::string str_res;
-        int argmax_idx;
-        int last_index = 0;
-        float score = 0.f;
-        int count = 0;
-        float max_value = 0.0f;
-
-        for (int n = 0; n < imgW; ++n) {
-            // 获取当前时间步的最大值索引
-            argmax_idx = int(std::distance(
-                &predict_batch[(m * imgW + n) * num_classes],
-                std::max_element(&predict_batch[(m * imgW + n) * num_classes],
-                                 &predict_batch[(m * imgW + n + 1) * num_classes])));
-            // 获取最大值
-            max_value = float(*std::max_element(
-                &predict_batch[(m * imgW + n) * num_classes],
-                &predict_batch[(m * imgW + n + 1) * num_classes]));
-
-            if (argmax_idx > 0 && (!(n > 0 && argmax_idx == last_index))) {
-                score += max_value;
-                count += 1;
-                str_res += labelList_[argmax_idx];
-            }
-            last_index = argmax_idx;
+    decoder_.decode(predict_batch, batch_size, imgW, num_classes, results);
+    return results;
+}
+
+std::vector<CtcResult> OCRWrapper::recognize(const std::vector<cv::Mat>& img_list,
+                                             std::vector<bool>* succeeded) {
+    std::vector<CtcResult> results(img_list.size());
+    if (succeeded) {
+        succeeded->assign(img_list.size(), false);
+    }
+    if (img_list.empty()) {
+        return results;
+    }
+
+    // 按宽高比排序后每 rec_batch_num 张一批，同批图像宽度接近，补齐浪费少
+    std::vector<float> width_list;
+    for (size_t i = 0; i < img_list.size(); ++i) {
+        width_list.emplace_back(float(img_list[i].cols) / img_list[i].rows);
+    }
+    std::vector<size_t> indices = argsort(width_list);
+
+    size_t rec_batch_num = (size_t)std::max(1, config_.recBatchNum);
+    if (maxBatch_ > 0) {
+        rec_batch_num = std::min(rec_batch_num, (size_t)maxBatch_);
+    }
+    for (size_t begin = 0; begin < img_list.size(); begin += rec_batch_num) {
+        size_t end = std::min(img_list.size(), begin + rec_batch_num);
+        int batch_num = 0;
+        int batch_width = 0;
+        {
+            METRICS_SCOPE("ocr_preprocess");
+            preprocess(img_list, indices, begin, end, batch_num, batch_width);
+        }
+
+        std::vector<int> predict_shape;
+        const float* output = nullptr;
+        {
+            METRICS_SCOPE("ocr_run");
+            output = run(predict_shape);
         }
-        score /= count;
-        if (std::isnan(score)) {
+        if (!output) {
             continue;
         }
-        results.push_back(str_res);
+
+        // 按 indices 还原为输入顺序，分桶补齐的空白图像结果直接丢弃
+        METRICS_SCOPE("ocr_postprocess");
+        std::vector<CtcResult> batch_results = postprocess(output, predict_shape);
+        for (size_t i = 0; i < batch_results.size() && begin + i < end; ++i) {
+            results[indices[begin + i]] = std::move(batch_results[i]);
+            if (succeeded) {
+                (*succeeded)[indices[begin + i]] = true;
+            }
+        }
     }
     return results;
 }
 
 std::vector<std::string> OCRWrapper::infer(const std::vector<cv::Mat>& img_list) {
-    std::vector<cv::Mat> norm_img_batch;
-    int batch_width = 0;
-    preprocess(img_list, norm_img_batch, batch_width);
+    std::vector<CtcResult> scored = inferWithScores(img_list);
+    std::vector<std::string> results;
+    results.reserve(scored.size());
+    for (auto& result : scored) {
+        results.push_back(std::move(result.text));
+    }
+    return results;
+}
+
+std::vector<CtcResult> OCRWrapper::inferWithScores(const std::vector<cv::Mat>& img_list) {
+    if (!config_.cacheEnable) {
+        return recognize(img_list);
+    }
+
+    // 先查缓存，只识别画面发生变化的 ROI
+    std::vector<CtcResult> results(img_list.size());
+    std::vector<std::vector<uchar>> signatures(img_list.size());
+    std::vector<cv::Mat> missed;
+    std::vector<size_t> missedIndices;
+    for (size_t i = 0; i < img_list.size(); ++i) {
+        computeSignature(img_list[i], signatures[i]);
+        if (lookupCache(signatures[i], results[i])) {
+            cacheHits_++;
+        } else {
+            cacheMisses_++;
+            missed.push_back(img_list[i]);
+            missedIndices.push_back(i);
+        }
+    }
+    if (missed.empty()) {
+        return results;
+    }
+
+    std::vector<bool> succeeded;
+    std::vector<CtcResult> recognized = recognize(missed, &succeeded);
+    for (size_t i = 0; i < missedIndices.size(); ++i) {
+        size_t idx = missedIndices[i];
+        results[idx] = recognized[i];
+        // 推理失败或识别为空的结果不缓存，否则画面不变时会一直返回空串而不再运行 OCR
+        if (succeeded[i] && !recognized[i].text.empty()) {
+            storeCache(std::move(signatures[idx]), recognized[i]);
+        }
+    }
+    return results;
+}
+
+// ROI 指纹：INTER_AREA 缩放到小尺寸后转灰度，对噪声不敏感，数字变化时差异明显
+void OCRWrapper::computeSignature(const cv::Mat& img, std::vector<uchar>& signature) {
+    int size = config_.cacheThumbSize;
+    cv::resize(img, thumb_, cv::Size(size, size), 0, 0, cv::INTER_AREA);
+    if (thumb_.channels() == 3) {
+        cv::cvtColor(thumb_, thumb_, cv::COLOR_BGR2GRAY);
+    }
+    signature.resize((size_t)size * size);
+    for (int y = 0; y < size; ++y) {
+        const uchar* row = thumb_.ptr<uchar>(y);
+        std::copy(row, row + size, signature.begin() + (size_t)y * size);
+    }
+}
+
+bool OCRWrapper::lookupCache(const std::vector<uchar>& signature, CtcResult& result) {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->signature.size() != signature.size()) continue;
 
-    std::vector<int> predict_shape;
-    std::vector<float> predict_batch = infer(norm_img_batch, batch_width, predict_shape);
+        int maxDiff = 0;
+        for (size_t i = 0; i < signature.size() && maxDiff <= config_.cacheTolerance; ++i) {
+            maxDiff = std::max(maxDiff, std::abs((int)it->signature[i] - (int)signature[i]));
+        }
+        if (maxDiff <= config_.cacheTolerance) {
+            result = it->result;
+            // 命中的条目移到队首
+            if (it != cache_.begin()) {
+                CacheEntry entry = std::move(*it);
+                cache_.erase(it);
+                cache_.push_front(std::move(entry));
+            }
+            return true;
+        }
+    }
+    return false;
+}
 
-    return postprocess(predict_batch, predict_shape);
-}
\ No newline at end of file
+void OCRWrapper::storeCache(std::vector<uchar> signature, const CtcResult& result) {
+    cache_.push_front(CacheEntry{std::move(signature), result});
+    while (cache_.size() > (size_t)std::max(1, config_.cacheCapacity)) {
+        cache_.pop_back();
+    }
+}
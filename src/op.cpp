@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "op.h"
+#include <opencv2/core/hal/intrin.hpp>
 
 namespace PaddleOCR {
 
@@ -54,6 +55,74 @@ void Normalize::Run(cv::Mat &im, const std::vector<float> &mean,
   cv::merge(bgr_channels, im);
 }
 
+void CrnnResizeNormPermute::Run(const cv::Mat &img, float *data, int imgH,
+                                int imgW, const std::vector<float> &mean,
+                                const std::vector<float> &scale,
+                                const bool is_scale,
+                                cv::Mat &resize_buffer) noexcept {
+  float ratio = float(img.cols) / float(img.rows);
+  int resize_w;
+  if (ceilf(imgH * ratio) > imgW)
+    resize_w = imgW;
+  else
+    resize_w = int(ceilf(imgH * ratio));
+
+  cv::resize(img, resize_buffer, cv::Size(resize_w, imgH), 0.f, 0.f,
+             cv::INTER_LINEAR);
+
+  // (v * e - mean) * scale = v * alpha + beta，补齐区域原为 0 像素，值为 beta
+  float e = is_scale ? 1.0f / 255.0f : 1.0f;
+  float alpha[3], beta[3];
+  for (int c = 0; c < 3; ++c) {
+    alpha[c] = e * scale[c];
+    beta[c] = -mean[c] * scale[c];
+  }
+
+  const int plane = imgH * imgW;
+  for (int y = 0; y < imgH; ++y) {
+    const uchar *src = resize_buffer.ptr<uchar>(y);
+    float *dst0 = data + y * imgW;
+    float *dst1 = dst0 + plane;
+    float *dst2 = dst1 + plane;
+    int x = 0;
+#if CV_SIMD128
+    const cv::v_float32x4 va0 = cv::v_setall_f32(alpha[0]);
+    const cv::v_float32x4 va1 = cv::v_setall_f32(alpha[1]);
+    const cv::v_float32x4 va2 = cv::v_setall_f32(alpha[2]);
+    const cv::v_float32x4 vb0 = cv::v_setall_f32(beta[0]);
+    const cv::v_float32x4 vb1 = cv::v_setall_f32(beta[1]);
+    const cv::v_float32x4 vb2 = cv::v_setall_f32(beta[2]);
+    auto store = [](const cv::v_uint8x16 &v, const cv::v_float32x4 &va,
+                    const cv::v_float32x4 &vb, float *dst) {
+      cv::v_uint16x8 lo16, hi16;
+      cv::v_uint32x4 q0, q1, q2, q3;
+      cv::v_expand(v, lo16, hi16);
+      cv::v_expand(lo16, q0, q1);
+      cv::v_expand(hi16, q2, q3);
+      cv::v_store(dst, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q0)), va, vb));
+      cv::v_store(dst + 4, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q1)), va, vb));
+      cv::v_store(dst + 8, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q2)), va, vb));
+      cv::v_store(dst + 12, cv::v_fma(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q3)), va, vb));
+    };
+    for (; x <= resize_w - 16; x += 16) {
+      cv::v_uint8x16 c0, c1, c2;
+      cv::v_load_deinterleave(src + x * 3, c0, c1, c2);
+      store(c0, va0, vb0, dst0 + x);
+      store(c1, va1, vb1, dst1 + x);
+      store(c2, va2, vb2, dst2 + x);
+    }
+#endif
+    for (; x < resize_w; ++x) {
+      dst0[x] = src[x * 3] * alpha[0] + beta[0];
+      dst1[x] = src[x * 3 + 1] * alpha[1] + beta[1];
+      dst2[x] = src[x * 3 + 2] * alpha[2] + beta[2];
+    }
+    std::fill(dst0 + resize_w, dst0 + imgW, beta[0]);
+    std::fill(dst1 + resize_w, dst1 + imgW, beta[1]);
+    std::fill(dst2 + resize_w, dst2 + imgW, beta[2]);
+  }
+}
+
 void ResizeImgType0::Run(const cv::Mat &img, cv::Mat &resize_img,
                          const std::string &limit_type, int limit_side_len,
                          float &ratio_h, float &ratio_w,
@@ -0,0 +1,40 @@
+#include "opencv_dnn_backend.h"
+#include <numeric>
+#include "logger.h"
+
+using namespace cv;
+using namespace std;
+
+OpenCvDnnBackend::OpenCvDnnBackend(const string& modelPath, vector<int64_t> inputShape)
+    : inputShape_(std::move(inputShape)) {
+    net_ = dnn::readNet(modelPath);
+    net_.setPreferableBackend(dnn::DNN_BACKEND_OPENCV);
+    net_.setPreferableTarget(dnn::DNN_TARGET_CPU);
+    inputShape_[0] = 1;
+}
+
+float* OpenCvDnnBackend::prepareInput(const vector<int64_t>& shape) {
+    blobShape_.assign(shape.begin(), shape.end());
+    size_t size = accumulate(blobShape_.begin(), blobShape_.end(), (size_t)1, multiplies<size_t>());
+    if (inputBuffer_.size() < size) {
+        inputBuffer_.resize(size);
+    }
+    return inputBuffer_.data();
+}
+
+const float* OpenCvDnnBackend::run(vector<int64_t>& outputShape) {
+    // 以 Mat 头包装输入缓冲区，不拷贝
+    Mat blob((int)blobShape_.size(), blobShape_.data(), CV_32F, inputBuffer_.data());
+    try {
+        net_.setInput(blob);
+        output_ = net_.forward();
+    } catch (const cv::Exception& e) {
+        LOG_ERROR("OpenCV DNN 推理失败: " << e.what());
+        return nullptr;
+    }
+    outputShape.clear();
+    for (int i = 0; i < output_.dims; ++i) {
+        outputShape.push_back(output_.size[i]);
+    }
+    return output_.ptr<float>();
+}
@@ -0,0 +1,106 @@
+#include "ort_backend.h"
+#include <algorithm>
+#include "data.h"
+#include "logger.h"
+
+using namespace std;
+
+OrtBackend::OrtBackend(const string& modelPath, int intraOpNumThreads)
+    : env_(ORT_LOGGING_LEVEL_WARNING, "YOLOv8-ONNXRuntime"),
+      memoryInfo_(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault)) {
+
+    sessionOptions_.SetIntraOpNumThreads(intraOpNumThreads);
+    sessionOptions_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+    // 创建 session
+    session_ = std::make_unique<Ort::Session>(env_, modelPath.c_str(), sessionOptions_);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    // 处理输入节点
+    for (size_t i = 0; i < session_->GetInputCount(); i++) {
+        inputNames_.push_back(session_->GetInputName(i, allocator));
+        Ort::TypeInfo inputTypeInfo = session_->GetInputTypeInfo(i);
+        inputShape_ = inputTypeInfo.GetTensorTypeAndShapeInfo().GetShape();
+    }
+
+    // 处理输出节点（以第一个输出为检测头）
+    for (size_t i = 0; i < session_->GetOutputCount(); i++) {
+        outputNames_.push_back(session_->GetOutputName(i, allocator));
+        if (i == 0) {
+            Ort::TypeInfo outputTypeInfo = session_->GetOutputTypeInfo(i);
+            outputShape_ = outputTypeInfo.GetTensorTypeAndShapeInfo().GetShape();
+        }
+    }
+}
+
+OrtBackend::~OrtBackend() {
+    // 清理输入输出名称
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (const char* name : inputNames_) {
+        allocator.Free(const_cast<void*>(static_cast<const void*>(name)));
+    }
+    for (const char* name : outputNames_) {
+        allocator.Free(const_cast<void*>(static_cast<const void*>(name)));
+    }
+}
+
+// 绑定输入输出缓冲区，仅在输入形状变化时重新绑定
+float* OrtBackend::prepareInput(const vector<int64_t>& shape) {
+    if (ioBinding_ && boundInputShape_ == shape) {
+        return inputTensorValues_.data();
+    }
+
+    if (!ioBinding_) {
+        ioBinding_ = std::make_unique<Ort::IoBinding>(*session_);
+    }
+    ioBinding_->ClearBoundInputs();
+    ioBinding_->ClearBoundOutputs();
+
+    vector<int64_t> inputTensorShape = shape;
+    inputTensorValues_.resize(data_utils::vectorProduct(inputTensorShape));
+    inputTensor_ = Ort::Value::CreateTensor<float>(
+        memoryInfo_, inputTensorValues_.data(), inputTensorValues_.size(),
+        inputTensorShape.data(), inputTensorShape.size());
+    ioBinding_->BindInput(inputNames_[0], inputTensor_);
+
+    // 除 batch 外输出形状固定时预分配输出缓冲区，否则交给 ORT 分配
+    vector<int64_t> outputTensorShape = outputShape_;
+    outputTensorShape[0] = shape[0];
+    isStaticOutputShape_ = all_of(outputTensorShape.begin(), outputTensorShape.end(),
+                                  [](int64_t dim) { return dim > 0; });
+    if (isStaticOutputShape_) {
+        outputTensorValues_.resize(data_utils::vectorProduct(outputTensorShape));
+        outputTensor_ = Ort::Value::CreateTensor<float>(
+            memoryInfo_, outputTensorValues_.data(), outputTensorValues_.size(),
+            outputTensorShape.data(), outputTensorShape.size());
+        ioBinding_->BindOutput(outputNames_[0], outputTensor_);
+    } else {
+        ioBinding_->BindOutput(outputNames_[0], memoryInfo_);
+    }
+    for (size_t i = 1; i < outputNames_.size(); i++) {
+        ioBinding_->BindOutput(outputNames_[i], memoryInfo_);
+    }
+
+    boundInputShape_ = inputTensorShape;
+    boundOutputShape_ = outputTensorShape;
+    return inputTensorValues_.data();
+}
+
+const float* OrtBackend::run(vector<int64_t>& outputShape) {
+    try {
+        session_->Run(runOptions_, *ioBinding_);
+    } catch (const Ort::Exception& e) {
+        LOG_ERROR("ONNX Runtime 推理失败: " << e.what());
+        return nullptr;
+    }
+
+    if (isStaticOutputShape_) {
+        outputShape = boundOutputShape_;
+        return outputTensorValues_.data();
+    }
+    // 输出尺寸随输入变化时由 ORT 分配输出
+    outputTensors_ = ioBinding_->GetOutputValues();
+    outputShape = outputTensors_[0].GetTensorTypeAndShapeInfo().GetShape();
+    return outputTensors_[0].GetTensorMutableData<float>();
+}
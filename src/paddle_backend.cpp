@@ -0,0 +1,110 @@
+#include "paddle_backend.h"
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include "logger.h"
+
+using namespace std;
+
+namespace {
+
+// /proc/cpuinfo 中是否有指定的 CPU 特性标志
+bool cpuHasFlag(const string& flag) {
+    ifstream cpuinfo("/proc/cpuinfo");
+    string line;
+    while (getline(cpuinfo, line)) {
+        if (line.compare(0, 5, "flags") != 0) continue;
+        return (line + " ").find(" " + flag + " ") != string::npos;
+    }
+    return false;
+}
+
+} // namespace
+
+PaddleBackend::PaddleBackend(const string& modelDir, const Options& options)
+    : imgH_(options.imgH), openvino_(options.openvino), precision_(options.precision) {
+    if (precision_ != "fp32" && precision_ != "bf16" && precision_ != "int8") {
+        LOG_WARN("未知的 OCR 计算精度 " << precision_ << "，使用 fp32");
+        precision_ = "fp32";
+    }
+    if (precision_ != "fp32" && !options.useMkldnn && !options.openvino) {
+        LOG_WARN("OCR " << precision_ << " 精度需要开启 MKLDNN，使用 fp32");
+        precision_ = "fp32";
+    }
+    if (precision_ == "bf16" && !cpuHasFlag("avx512_bf16") && !cpuHasFlag("amx_bf16")) {
+        LOG_WARN("CPU 不支持 bf16 指令（avx512_bf16 / amx_bf16），OCR 使用 fp32");
+        precision_ = "fp32";
+    }
+
+    try {
+        // 初始化配置
+        paddle_infer::Config paddleConfig;
+        paddleConfig.SetModel(modelDir + "/inference.pdmodel",
+                              modelDir + "/inference.pdiparams");
+        if (options.openvino) {
+            paddleConfig.EnableOpenVINOEngine(precision_ == "bf16" ? paddle_infer::PrecisionType::kBf16
+                                              : precision_ == "int8" ? paddle_infer::PrecisionType::kInt8
+                                              : paddle_infer::PrecisionType::kFloat32);
+        } else if (options.useMkldnn) {
+            paddleConfig.EnableMKLDNN();  // 启用 MKLDNN 加速
+            if (precision_ == "bf16") {
+                paddleConfig.EnableMkldnnBfloat16();
+            } else if (precision_ == "int8") {
+                // 量化模型中的 quantize/dequantize 算子由 int8 pass 融合为 MKLDNN int8 内核
+                paddleConfig.EnableMkldnnInt8();
+            }
+        } else {
+            paddleConfig.DisableMKLDNN();
+        }
+        paddleConfig.SetCpuMathLibraryNumThreads(options.numThreads);
+        paddleConfig.EnableMemoryOptim();  // 启用内存优化
+
+        // 创建推理器
+        predictor_ = paddle_infer::CreatePredictor(paddleConfig);
+        if (!predictor_) {
+            throw runtime_error("Failed to create predictor");
+        }
+    } catch (const std::exception& e) {
+        cerr << "OCR初始化失败: " << e.what() << endl;
+        predictor_ = nullptr;
+    }
+
+    if (predictor_) {
+        inputHandle_ = predictor_->GetInputHandle(predictor_->GetInputNames()[0]);
+        outputHandle_ = predictor_->GetOutputHandle(predictor_->GetOutputNames()[0]);
+    }
+}
+
+float* PaddleBackend::prepareInput(const vector<int64_t>& shape) {
+    inputShape_.assign(shape.begin(), shape.end());
+    size_t size = accumulate(inputShape_.begin(), inputShape_.end(), (size_t)1, multiplies<size_t>());
+    if (inputBuffer_.size() < size) {
+        inputBuffer_.resize(size);
+    }
+    return inputBuffer_.data();
+}
+
+const float* PaddleBackend::run(vector<int64_t>& outputShape) {
+    if (!inputHandle_ || !outputHandle_) {
+        return nullptr;
+    }
+
+    // 输入直接共享常驻缓冲区，省去 CopyFromCpu
+    inputHandle_->ShareExternalData<float>(inputBuffer_.data(), inputShape_, paddle_infer::PlaceType::kCPU);
+
+    try {
+        predictor_->Run();
+    } catch (const std::exception& e) {
+        LOG_ERROR("OCR推理失败: " << e.what());
+        return nullptr;
+    }
+
+    vector<int> shape = outputHandle_->shape();
+    size_t outNum = accumulate(shape.begin(), shape.end(), (size_t)1, multiplies<size_t>());
+    if (outputBuffer_.size() < outNum) {
+        outputBuffer_.resize(outNum);
+    }
+    outputHandle_->CopyToCpu(outputBuffer_.data());
+    outputShape.assign(shape.begin(), shape.end());
+    return outputBuffer_.data();
+}
@@ -0,0 +1,698 @@
+#include "pipeline.h"
+#include <iostream>
+#include <iomanip>
+#include "utils.h"
+#include "data.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+// 计算自 start 以来经过的微秒数
+int64_t elapsedUs(const chrono::steady_clock::time_point& start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+const char* statusNameOf(TrafficSignalStatus status) {
+    switch (status) {
+        case TrafficSignalStatus::Normal: return "normal";
+        case TrafficSignalStatus::SignalMissing: return "signal_missing";
+        case TrafficSignalStatus::TimerMissing: return "timer_missing";
+    }
+    return "";
+}
+
+const char* englishColorOf(int classId) {
+    switch (classId) {
+        case 0: return "green";
+        case 1: return "red";
+        case 2: return "yellow";
+    }
+    return "";
+}
+
+const char* colorNameOf(int classId) {
+    switch (classId) {
+        case 0: return "绿";
+        case 1: return "红";
+        case 2: return "黄";
+    }
+    return "";
+}
+}
+
+FramePipeline::FramePipeline(const Config& config,
+                             VideoCapture& cap,
+                             YOLOWrapper& yolo,
+                             OCRWrapper& ocr,
+                             VideoEncoder* videoEncoder,
+                             const vector<string>& classNames)
+    : config_(config), yolo_(yolo), ocr_(ocr), classNames_(classNames),
+      detectInQueue_(config.queueCapacity), ocrInQueue_(config.queueCapacity),
+      detectOutQueue_(config.queueCapacity), ocrOutQueue_(config.queueCapacity),
+      frameDumper_(config.frameDump), resultStream_(config.resultStream) {
+    Stream stream;
+    stream.name = "default";
+    stream.cap = &cap;
+    stream.videoEncoder = videoEncoder;
+    addStream(stream);
+
+    captureStats_.name = "capture";
+    detectStats_.name = "detect";
+    ocrStats_.name = "ocr";
+    renderStats_.name = "render";
+}
+
+// 多路时队列容量按路数放大，避免各路采集线程互相阻塞
+FramePipeline::FramePipeline(const Config& config,
+                             const vector<Stream>& streams,
+                             YOLOWrapper& yolo,
+                             OCRWrapper& ocr,
+                             const vector<string>& classNames)
+    : config_(config), yolo_(yolo), ocr_(ocr), classNames_(classNames),
+      detectInQueue_(config.queueCapacity * max<size_t>(1, streams.size())),
+      ocrInQueue_(config.queueCapacity * max<size_t>(1, streams.size())),
+      detectOutQueue_(config.queueCapacity * max<size_t>(1, streams.size())),
+      ocrOutQueue_(config.queueCapacity * max<size_t>(1, streams.size())),
+      frameDumper_(config.frameDump), resultStream_(config.resultStream) {
+    for (const Stream& stream : streams) {
+        addStream(stream);
+    }
+
+    captureStats_.name = "capture";
+    detectStats_.name = "detect";
+    ocrStats_.name = "ocr";
+    renderStats_.name = "render";
+}
+
+void FramePipeline::addStream(const Stream& stream) {
+    unique_ptr<StreamState> state(new StreamState);
+    state->stream = stream;
+
+    // 流未单独配置区域时使用全局区域，都未配置时退化为整帧
+    if (state->stream.lightROIs.empty()) {
+        state->stream.lightROIs = config_.lightROIs;
+    }
+    if (state->stream.timerROIs.empty()) {
+        state->stream.timerROIs = config_.timerROIs;
+    }
+    vector<RegionOfInterest>& lightROIs = state->stream.lightROIs;
+    vector<RegionOfInterest>& timerROIs = state->stream.timerROIs;
+    if (lightROIs.empty()) {
+        lightROIs.push_back(RegionOfInterest{"default", Rect(), ""});
+    }
+    if (timerROIs.empty()) {
+        timerROIs.push_back(RegionOfInterest{"default", Rect(), ""});
+    }
+
+    for (size_t i = 0; i < lightROIs.size(); ++i) {
+        state->detectionSchedulers.emplace_back(new DetectionScheduler(config_.detectionScheduler));
+    }
+    for (size_t i = 0; i < timerROIs.size(); ++i) {
+        state->timerTrackers.emplace_back(new TimerTracker(config_.timerTracker));
+
+        // 计时区域按名称关联信号灯区域，未指定时取同下标（超出时取第一个）
+        const string& light = timerROIs[i].light;
+        size_t lightIndex = i < lightROIs.size() ? i : 0;
+        for (size_t j = 0; j < lightROIs.size() && !light.empty(); ++j) {
+            if (lightROIs[j].name == light) {
+                lightIndex = j;
+                break;
+            }
+        }
+        state->timerLightIndex.push_back(lightIndex);
+    }
+    state->signalAnomalyCounters.assign(lightROIs.size(), 0);
+    state->ocrAnomalyCounters.assign(timerROIs.size(), 0);
+    streams_.push_back(std::move(state));
+}
+
+FramePipeline::~FramePipeline() {
+    for (int id : metricIds_) {
+        Metrics::instance().removeCallback(id);
+    }
+    stop();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void FramePipeline::stop() {
+    stopRequested_ = true;
+    for (auto& state : streams_) {
+        if (state->grabber) state->grabber->stop();
+    }
+    detectInQueue_.close();
+    ocrInQueue_.close();
+    detectOutQueue_.close();
+    ocrOutQueue_.close();
+}
+
+void FramePipeline::captureLoop(size_t streamIndex) {
+    StreamState& state = *streams_[streamIndex];
+    VideoCapture& cap = *state.stream.cap;
+    FrameGrabber* grabber = state.grabber.get();
+    FrameGrabber::Frame grabbed;
+    int64_t index = 0;
+    while (!stopRequested_) {
+        // latest 模式：下游有空位时再取最新帧，避免取到的帧在队列外等待而变旧
+        if (grabber && (!detectInQueue_.waitForSpace() || !ocrInQueue_.waitForSpace())) break;
+
+        auto start = chrono::steady_clock::now();
+        auto packet = make_shared<FramePacket>();
+        packet->stream = streamIndex;
+        if (grabber) {
+            if (!grabber->read(grabbed)) break;
+            packet->frame = grabbed.frame;
+            packet->captureTime = grabbed.grabTime;
+            packet->index = grabbed.sequence - 1;
+            packet->timestampMs = state.useVideoClock
+                ? grabbed.posMsec
+                : chrono::duration<double, milli>(grabbed.grabTime - startTime_).count();
+        } else {
+            {
+                METRICS_SCOPE("decode");
+                cap >> packet->frame;
+            }
+            if (packet->frame.empty()) break;
+            packet->captureTime = chrono::steady_clock::now();
+            packet->index = index++;
+            packet->timestampMs = state.useVideoClock
+                ? cap.get(CAP_PROP_POS_MSEC)
+                : chrono::duration<double, milli>(chrono::steady_clock::now() - startTime_).count();
+        }
+        captureStats_.busyUs += elapsedUs(start);
+        captureStats_.frames++;
+
+        // 同一帧同时送入检测和 OCR 两个分支，两者只写各自的字段
+        lock_guard<mutex> lock(captureMutex_);
+        if (!detectInQueue_.push(packet) || !ocrInQueue_.push(packet)) break;
+    }
+    if (grabber) {
+        grabber->stop();
+    }
+
+    // 最后一路采集结束时关闭下游队列
+    if (--activeCaptures_ == 0) {
+        detectInQueue_.close();
+        ocrInQueue_.close();
+    }
+}
+
+bool FramePipeline::popBatch(BoundedQueue<PacketPtr>& queue, vector<PacketPtr>& batch) {
+    batch.clear();
+    PacketPtr packet;
+    if (!queue.pop(packet)) return false;
+    batch.push_back(std::move(packet));
+
+    // 单路时逐帧处理，合批只会增加延迟
+    size_t maxBatch = streams_.size() > 1 ? (size_t)max(1, config_.maxBatchFrames) : 1;
+    while (batch.size() < maxBatch && queue.tryPop(packet)) {
+        batch.push_back(std::move(packet));
+    }
+    return true;
+}
+
+void FramePipeline::splitRounds(const vector<PacketPtr>& batch, vector<vector<PacketPtr>>& rounds) {
+    rounds.clear();
+    vector<size_t> nextRound(streams_.size(), 0);
+    for (const PacketPtr& packet : batch) {
+        size_t round = nextRound[packet->stream]++;
+        if (round >= rounds.size()) rounds.resize(round + 1);
+        rounds[round].push_back(packet);
+    }
+}
+
+void FramePipeline::detectLoop() {
+    vector<PacketPtr> batch;
+    vector<vector<PacketPtr>> rounds;
+    while (popBatch(detectInQueue_, batch)) {
+        auto start = chrono::steady_clock::now();
+        splitRounds(batch, rounds);
+        for (const auto& round : rounds) {
+            METRICS_SCOPE("detect");
+            detectRound(round);
+        }
+        detectStats_.busyUs += elapsedUs(start);
+        detectStats_.frames += batch.size();
+
+        bool closed = false;
+        for (PacketPtr& packet : batch) {
+            if (!detectOutQueue_.push(std::move(packet))) {
+                closed = true;
+                break;
+            }
+        }
+        if (closed) break;
+    }
+    detectOutQueue_.close();
+}
+
+void FramePipeline::detectRound(const vector<PacketPtr>& round) {
+    // 本轮所有帧中需要检测的区域合并为一次批量推理
+    vector<Mat> crops;
+    vector<Mat> keyCrops;
+    vector<pair<size_t, size_t>> cropOwners;  // (帧在本轮中的下标, 区域下标)
+    vector<size_t> keyIndices;                // 关键区域在 crops 中的下标
+
+    for (size_t f = 0; f < round.size(); ++f) {
+        FramePacket& packet = *round[f];
+        StreamState& state = *streams_[packet.stream];
+        const vector<RegionOfInterest>& rois = state.stream.lightROIs;
+        packet.detections.assign(rois.size(), vector<Detection>());
+
+        // 非关键帧沿用跟踪的检测框，跟踪校验失败时退回运行检测器
+        for (size_t i = 0; i < rois.size(); ++i) {
+            Mat crop = cropROI(packet.frame, rois[i].rect);
+            DetectionScheduler& scheduler = *state.detectionSchedulers[i];
+            bool keyframe = scheduler.shouldDetect(crop);
+            if (!keyframe) {
+                keyframe = !scheduler.track(crop, packet.detections[i]);
+            }
+            if (keyframe) {
+                keyIndices.push_back(crops.size());
+                keyCrops.push_back(crop);
+            }
+            crops.push_back(crop);
+            cropOwners.emplace_back(f, i);
+        }
+    }
+
+    if (!keyCrops.empty()) {
+        vector<vector<Detection>> results = yolo_.infer(keyCrops);
+        for (size_t k = 0; k < keyIndices.size() && k < results.size(); ++k) {
+            size_t c = keyIndices[k];
+            FramePacket& packet = *round[cropOwners[c].first];
+            size_t i = cropOwners[c].second;
+            packet.detections[i] = std::move(results[k]);
+            streams_[packet.stream]->detectionSchedulers[i]->update(crops[c], packet.detections[i]);
+        }
+    }
+
+    // 检测结果映射回原始帧坐标系
+    for (const PacketPtr& packet : round) {
+        const vector<RegionOfInterest>& rois = streams_[packet->stream]->stream.lightROIs;
+        for (size_t i = 0; i < rois.size(); ++i) {
+            const Rect& roi = rois[i].rect;
+            if (roi.area() <= 0) continue;
+            for (auto& detection : packet->detections[i]) {
+                detection.box.x += roi.x;
+                detection.box.y += roi.y;
+            }
+        }
+    }
+}
+
+void FramePipeline::ocrLoop() {
+    vector<PacketPtr> batch;
+    vector<vector<PacketPtr>> rounds;
+    while (popBatch(ocrInQueue_, batch)) {
+        auto start = chrono::steady_clock::now();
+        splitRounds(batch, rounds);
+        for (const auto& round : rounds) {
+            METRICS_SCOPE("ocr");
+            ocrRound(round);
+        }
+        ocrStats_.busyUs += elapsedUs(start);
+        ocrStats_.frames += batch.size();
+
+        bool closed = false;
+        for (PacketPtr& packet : batch) {
+            if (!ocrOutQueue_.push(std::move(packet))) {
+                closed = true;
+                break;
+            }
+        }
+        if (closed) break;
+    }
+    ocrOutQueue_.close();
+}
+
+void FramePipeline::ocrRound(const vector<PacketPtr>& round) {
+    // 本轮所有帧中需要识别的计时区域合并为一次批量识别
+    vector<Mat> ocrCrops;
+    vector<pair<size_t, size_t>> ocrOwners;  // (帧在本轮中的下标, 区域下标)
+
+    for (size_t f = 0; f < round.size(); ++f) {
+        FramePacket& packet = *round[f];
+        StreamState& state = *streams_[packet.stream];
+        const vector<RegionOfInterest>& rois = state.stream.timerROIs;
+        packet.timerValues.assign(rois.size(), string());
+
+        // 倒计时跟踪器锁定后，只在预计跳变附近或周期校验时运行 OCR
+        for (size_t i = 0; i < rois.size(); ++i) {
+            TimerTracker& tracker = *state.timerTrackers[i];
+            if (tracker.shouldRunOcr(packet.timestampMs)) {
+                ocrCrops.push_back(cropROI(packet.frame, rois[i].rect));
+                ocrOwners.emplace_back(f, i);
+            } else {
+                packet.timerValues[i] = tracker.predict(packet.timestampMs);
+            }
+        }
+    }
+
+    if (!ocrCrops.empty()) {
+        vector<string> ocrResults = ocr_.infer(ocrCrops);
+        for (size_t k = 0; k < ocrOwners.size(); ++k) {
+            FramePacket& packet = *round[ocrOwners[k].first];
+            size_t i = ocrOwners[k].second;
+            string reading = k < ocrResults.size() ? ocrResults[k] : "";
+            packet.timerValues[i] = streams_[packet.stream]->timerTrackers[i]->update(packet.timestampMs, reading);
+        }
+    }
+}
+
+void FramePipeline::renderFrame(FramePacket& packet) {
+    METRICS_SCOPE("render");
+    Mat& frame = packet.frame;
+    StreamState& state = *streams_[packet.stream];
+    const vector<RegionOfInterest>& lightROIs = state.stream.lightROIs;
+    const vector<RegionOfInterest>& timerROIs = state.stream.timerROIs;
+    TrafficSignalStatus& status = state.status;
+    LOG_DEBUG("<" << state.stream.name << "> 帧 " << packet.index);
+
+    // 任一信号灯区域缺失检测即累计该区域的异常
+    bool allDetected = true;
+    for (size_t i = 0; i < lightROIs.size(); ++i) {
+        const string& name = lightROIs[i].name;
+        const vector<Detection>& detections = packet.detections[i];
+        LOG_DEBUG("[" << name << "] 检测到目标数量: " << detections.size());
+
+        if (detections.empty()) {
+            allDetected = false;
+            state.signalAnomalyCounters[i]++;
+            if (state.signalAnomalyCounters[i] >= config_.signalAnomalyThreshold) {
+                LOG_WARN("[报警] <" << state.stream.name << "> [" << name << "] 连续 "
+                         << state.signalAnomalyCounters[i] << " 帧未检测到信号灯");
+                status = TrafficSignalStatus::SignalMissing;
+                state.signalAnomalyCounters[i] = 0;
+            }
+        } else {
+            state.signalAnomalyCounters[i] = 0;  // 信号灯正常时重置
+        }
+    }
+    if (allDetected) {
+        status = TrafficSignalStatus::Normal;
+    }
+
+    bool timerAnomaly = false;
+    for (size_t i = 0; i < timerROIs.size(); ++i) {
+        const string& timerValue = packet.timerValues[i];
+        LOG_DEBUG("[" << timerROIs[i].name << "] timerValue: " << timerValue);
+        if (timerValue.empty()) {
+            timerAnomaly = true;
+            state.ocrAnomalyCounters[i]++;
+        } else {
+            state.ocrAnomalyCounters[i] = 0;
+        }
+    }
+    if (timerAnomaly) {
+        // 仅在当前状态正常时更新为OCR异常
+        if (status == TrafficSignalStatus::Normal) {
+            status = TrafficSignalStatus::TimerMissing;
+        }
+    } else {
+        status = TrafficSignalStatus::Normal;
+    }
+    LOG_DEBUG("timerAnomaly: " << timerAnomaly);
+    if (packet.stream == 0) {
+        currentStatus = status;
+    }
+
+    // 每个计时区域取所属信号灯区域的第一个检测结果作为当前信号灯颜色
+    for (size_t i = 0; i < timerROIs.size(); ++i) {
+        const vector<Detection>& detections = packet.detections[state.timerLightIndex[i]];
+        const string& timerValue = packet.timerValues[i];
+        if (!timerValue.empty()) {
+            string colorName = detections.empty() ? "" : colorNameOf(detections[0].classId);
+            LOG_DEBUG("[正常] [" << timerROIs[i].name << "] " << colorName
+                      << "灯亮 剩余时间: " << timerValue << "秒");
+        }
+    }
+
+    // 以第一个计时区域及其信号灯为准判断状态变化
+    const vector<Detection>& primary = packet.detections[state.timerLightIndex[0]];
+    string primaryColor = primary.empty() ? "" : colorNameOf(primary[0].classId);
+    bool transition = !state.hasLastFrame || status != state.lastStatus || primaryColor != state.lastColor;
+    if (transition) {
+        LOG_INFO("<" << state.stream.name << "> 状态: " << statusNameOf(status)
+                 << (primaryColor.empty() ? "" : " " + primaryColor + "灯"));
+    }
+    state.hasLastFrame = true;
+    state.lastStatus = status;
+    state.lastColor = primaryColor;
+
+    // 结构化结果：状态、颜色或读数变化时，或按固定间隔输出
+    if (resultStream_.enabled()) {
+        ResultStream::Record record;
+        record.stream = state.stream.name;
+        record.frame = packet.index;
+        record.timestampMs = packet.timestampMs;
+        record.status = statusNameOf(status);
+        record.color = primary.empty() ? "" : englishColorOf(primary[0].classId);
+        string key = record.status + "|" + record.color;
+        for (size_t i = 0; i < timerROIs.size(); ++i) {
+            record.timers.emplace_back(timerROIs[i].name, packet.timerValues[i]);
+            key += "|" + packet.timerValues[i];
+        }
+        bool changed = !state.hasLastResult || key != state.lastResultKey;
+        if (resultStream_.due(changed, packet.timestampMs - state.lastResultMs)) {
+            resultStream_.emit(record);
+            state.hasLastResult = true;
+            state.lastResultKey = key;
+            state.lastResultMs = packet.timestampMs;
+        }
+    }
+
+    // 无界面运行时只有视频输出、调试帧转储或显示窗口需要叠加绘制，都不需要时跳过
+    VideoEncoder* videoEncoder = state.stream.videoEncoder;
+    bool encode = videoEncoder && videoEncoder->isOpened();
+    bool dump = frameDumper_.wanted(packet.index, transition, status != TrafficSignalStatus::Normal);
+    if (!encode && !dump && !config_.display) {
+        state.frames++;
+        return;
+    }
+
+    // 绘制状态信息
+    drawStatusInfo(frame, status, primaryColor, packet.timerValues[0]);
+
+    // 可视化部分调整
+    for (size_t i = 0; i < timerROIs.size(); ++i) {
+        drawTimerInfo(frame, timerROIs[i].rect, packet.timerValues[i]);
+    }
+
+    // 使用通用可视化函数
+    for (auto& detections : packet.detections) {
+        data_utils::visualizeDetection(frame, detections, classNames_);
+    }
+
+    // 调试帧按采样间隔、状态变化或异常异步保存
+    if (dump) {
+        string fileName = streams_.size() > 1
+            ? format("%s_frame_%04d.jpg", state.stream.name.c_str(), (int)packet.index)
+            : format("frame_%04d.jpg", (int)packet.index);
+        frameDumper_.submit(frame, fileName);
+    }
+
+    // 如果启用了视频输出，将当前帧交给该路的编码线程
+    if (encode) {
+        videoEncoder->write(frame);
+    }
+
+    if (config_.display) {
+        imshow(state.stream.name, frame);
+    }
+    state.frames++;
+}
+
+int64_t FramePipeline::run() {
+    startTime_ = chrono::steady_clock::now();
+
+    // 视频文件使用视频时间戳，摄像头/网络流使用系统时钟
+    const string& clock = config_.timerTracker.clock;
+    activeCaptures_ = (int)streams_.size();
+    for (size_t i = 0; i < streams_.size(); ++i) {
+        StreamState& state = *streams_[i];
+        bool isFile = state.stream.cap->get(CAP_PROP_FRAME_COUNT) > 0;
+        state.useVideoClock = clock == "video" || (clock == "auto" && isFile);
+
+        // 实时流只处理最新帧，视频文件逐帧处理
+        const string& mode = config_.captureMode;
+        if (mode == "latest" || (mode == "auto" && !isFile)) {
+            state.grabber.reset(new FrameGrabber(*state.stream.cap, config_.captureRingSize));
+            state.grabber->start();
+        }
+        workers_.emplace_back(&FramePipeline::captureLoop, this, i);
+    }
+    registerMetrics();
+    workers_.emplace_back(&FramePipeline::detectLoop, this);
+    workers_.emplace_back(&FramePipeline::ocrLoop, this);
+
+    // 合并检测和 OCR 两个分支的结果：两个队列均按帧序输出，逐一配对即可保持顺序
+    LatencyHistogram* frameLatency = Metrics::instance().histogram("frame_latency");
+    PacketPtr detected, recognized;
+    int64_t processed = 0;
+    while (detectOutQueue_.pop(detected) && ocrOutQueue_.pop(recognized)) {
+        if (detected != recognized) {
+            LOG_ERROR("pipeline frame order mismatch (" << detected->index
+                      << " vs " << recognized->index << ")");
+            break;
+        }
+
+        auto start = chrono::steady_clock::now();
+        renderFrame(*detected);
+        renderStats_.busyUs += elapsedUs(start);
+        renderStats_.frames++;
+        processed++;
+        if (frameLatency) {
+            frameLatency->record(elapsedUs(detected->captureTime));
+        }
+
+        if (config_.reportInterval > 0 && processed % config_.reportInterval == 0) {
+            printReport();
+        }
+        if (config_.display && waitKey(1) == 27) break;  // 按下 ESC 键退出
+    }
+
+    stop();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+    frameDumper_.stop();
+    resultStream_.stop();
+    printReport();
+    return processed;
+}
+
+void FramePipeline::registerMetrics() {
+    Metrics& metrics = Metrics::instance();
+    if (!metrics.enabled() || !metricIds_.empty()) return;
+
+    // 回调只在导出时由导出线程调用，读取的都是原子计数或加锁的队列大小
+    const pair<const char*, BoundedQueue<PacketPtr>*> queues[] = {
+        {"detect_in", &detectInQueue_}, {"ocr_in", &ocrInQueue_},
+        {"detect_out", &detectOutQueue_}, {"ocr_out", &ocrOutQueue_}};
+    for (const auto& queue : queues) {
+        BoundedQueue<PacketPtr>* q = queue.second;
+        metricIds_.push_back(metrics.addCallback("tld_queue_depth", string("queue=\"") + queue.first + "\"",
+                                                 "gauge", [q] { return (double)q->size(); }));
+    }
+    metricIds_.push_back(metrics.addCallback("tld_dropped_total", "source=\"frame_dump\"", "counter",
+                                             [this] { return (double)frameDumper_.dropped(); }));
+    metricIds_.push_back(metrics.addCallback("tld_dropped_total", "source=\"result_stream\"", "counter",
+                                             [this] { return (double)resultStream_.dropped(); }));
+    metricIds_.push_back(metrics.addCallback("tld_dropped_total", "source=\"log\"", "counter",
+                                             [] { return (double)Logger::instance().dropped(); }));
+
+    for (auto& item : streams_) {
+        StreamState* state = item.get();
+        string label = "stream=\"" + state->stream.name + "\"";
+        metricIds_.push_back(metrics.addCallback("tld_frames_total", label, "counter",
+                                                 [state] { return (double)state->frames; }));
+        if (state->grabber) {
+            FrameGrabber* grabber = state->grabber.get();
+            metricIds_.push_back(metrics.addCallback("tld_dropped_total", label + ",source=\"capture\"", "counter",
+                                                     [grabber] { return (double)grabber->dropped(); }));
+        }
+        VideoEncoder* encoder = state->stream.videoEncoder;
+        if (encoder && encoder->isOpened()) {
+            metricIds_.push_back(metrics.addCallback("tld_dropped_total", label + ",source=\"encoder\"", "counter",
+                                                     [encoder] { return (double)encoder->dropped(); }));
+            metricIds_.push_back(metrics.addCallback("tld_queue_depth", label + ",queue=\"encoder\"", "gauge",
+                                                     [encoder] { return (double)encoder->pending(); }));
+            metricIds_.push_back(metrics.addCallback("tld_encoder_lag_seconds", label + ",stat=\"mean\"", "gauge",
+                                                     [encoder] { return encoder->averageLagMs() / 1000.0; }));
+            metricIds_.push_back(metrics.addCallback("tld_encoder_lag_seconds", label + ",stat=\"max\"", "gauge",
+                                                     [encoder] { return encoder->maxLagMs() / 1000.0; }));
+        }
+    }
+}
+
+void FramePipeline::printReport() const {
+    double wallMs = elapsedUs(startTime_) / 1000.0;
+    uint64_t rendered = renderStats_.frames;
+    cout << "---------- 流水线统计 ----------" << endl;
+    cout << fixed << setprecision(2);
+    cout << "帧数: " << rendered << "  耗时: " << wallMs << " ms  端到端FPS: "
+         << (wallMs > 0 ? rendered * 1000.0 / wallMs : 0.0) << endl;
+
+    // 阶段利用率 = 忙碌时间 / 墙钟时间，最接近 100% 的阶段即为瓶颈
+    for (const StageStats* stats : {&captureStats_, &detectStats_, &ocrStats_, &renderStats_}) {
+        uint64_t frames = stats->frames;
+        double busyMs = stats->busyUs / 1000.0;
+        cout << "  [" << stats->name << "] 帧数: " << frames
+             << "  平均耗时: " << (frames ? busyMs / frames : 0.0) << " ms"
+             << "  利用率: " << (wallMs > 0 ? busyMs * 100.0 / wallMs : 0.0) << "%" << endl;
+    }
+
+    uint64_t hits = ocr_.cacheHits();
+    uint64_t misses = ocr_.cacheMisses();
+    if (hits + misses > 0) {
+        cout << "  OCR缓存 命中: " << hits << "  未命中: " << misses
+             << "  命中率: " << hits * 100.0 / (hits + misses) << "%" << endl;
+    }
+
+    if (resultStream_.enabled()) {
+        cout << "  结果流 已输出: " << resultStream_.written() << "  丢弃: " << resultStream_.dropped() << endl;
+    }
+    if (Logger::instance().dropped() > 0) {
+        cout << "  日志 缓冲区满丢弃: " << Logger::instance().dropped() << endl;
+    }
+    if (config_.frameDump.enable) {
+        cout << "  调试帧 已保存: " << frameDumper_.written() << "  队满丢弃: " << frameDumper_.dropped()
+             << "  写入失败: " << frameDumper_.failed() << endl;
+    }
+
+    for (const auto& stream : streams_) {
+        const StreamState& state = *stream;
+        string prefix = streams_.size() > 1 ? "  <" + state.stream.name + ">" : " ";
+        if (streams_.size() > 1) {
+            cout << prefix << " 帧数: " << state.frames << endl;
+        }
+        if (state.stream.videoEncoder && state.stream.videoEncoder->isOpened()) {
+            const VideoEncoder& encoder = *state.stream.videoEncoder;
+            cout << prefix << " 视频编码 已写入: " << encoder.written() << "  丢弃: " << encoder.dropped()
+                 << "  待编码: " << encoder.pending()
+                 << "  编码延迟 平均: " << encoder.averageLagMs() << " ms  最大: " << encoder.maxLagMs() << " ms"
+                 << "  阻塞: " << encoder.blockedMs() << " ms" << endl;
+        }
+        if (state.grabber) {
+            uint64_t grabbed = state.grabber->grabbed();
+            uint64_t dropped = state.grabber->dropped();
+            cout << prefix << " 采集(最新帧模式) 读取: " << grabbed << "  丢弃: " << dropped
+                 << "  丢帧率: " << (grabbed ? dropped * 100.0 / grabbed : 0.0) << "%" << endl;
+        }
+        if (config_.detectionScheduler.enable) {
+            for (size_t i = 0; i < state.detectionSchedulers.size(); ++i) {
+                const DetectionScheduler& scheduler = *state.detectionSchedulers[i];
+                cout << prefix << " [" << state.stream.lightROIs[i].name << "] 关键帧检测 YOLO执行: "
+                     << scheduler.keyframes()
+                     << "  跟踪: " << scheduler.trackedFrames()
+                     << "  当前间隔: " << scheduler.interval() << endl;
+            }
+        }
+        if (config_.timerTracker.enable) {
+            for (size_t i = 0; i < state.timerTrackers.size(); ++i) {
+                const TimerTracker& tracker = *state.timerTrackers[i];
+                cout << prefix << " [" << state.stream.timerROIs[i].name << "] 倒计时跟踪 OCR执行: "
+                     << tracker.ocrRuns()
+                     << "  跳过: " << tracker.ocrSkips()
+                     << "  锁定: " << (tracker.locked() ? "是" : "否") << endl;
+            }
+        }
+    }
+
+    struct QueueRow { const char* name; const BoundedQueue<PacketPtr>* queue; };
+    for (const QueueRow& row : {QueueRow{"capture->detect", &detectInQueue_},
+                                QueueRow{"capture->ocr", &ocrInQueue_},
+                                QueueRow{"detect->render", &detectOutQueue_},
+                                QueueRow{"ocr->render", &ocrOutQueue_}}) {
+        cout << "  <" << row.name << "> 平均占用: " << row.queue->averageOccupancy()
+             << "/" << row.queue->capacity()
+             << "  峰值: " << row.queue->peakOccupancy()
+             << "  背压阻塞: " << row.queue->blockedMs() << " ms" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
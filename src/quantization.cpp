@@ -0,0 +1,147 @@
+#include "quantization.h"
+#include <yaml-cpp/yaml.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include "logger.h"
+
+using namespace std;
+
+namespace {
+
+// 两个路径是否指向同一文件：字符串相同，或规范化后的绝对路径相同
+bool samePath(const string& a, const string& b) {
+    if (a == b) return true;
+    char resolvedA[PATH_MAX], resolvedB[PATH_MAX];
+    return realpath(a.c_str(), resolvedA) && realpath(b.c_str(), resolvedB) &&
+           string(resolvedA) == resolvedB;
+}
+
+// 最后修改时间；目录（Paddle 模型目录）取其中文件的最新修改时间，不存在时返回 -1
+time_t modifiedTime(const string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return -1;
+    time_t latest = info.st_mtime;
+    if (!S_ISDIR(info.st_mode)) return latest;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return latest;
+    while (dirent* entry = readdir(dir)) {
+        struct stat child;
+        if (stat((path + "/" + entry->d_name).c_str(), &child) == 0 && child.st_mtime > latest) {
+            latest = child.st_mtime;
+        }
+    }
+    closedir(dir);
+    return latest;
+}
+
+} // namespace
+
+bool quantization::writeReport(const string& path, const Report& report) {
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    out << YAML::Key << "fp32_model" << YAML::Value << report.fp32Model;
+    out << YAML::Key << "int8_model" << YAML::Value << report.int8Model;
+    out << YAML::Key << "frames" << YAML::Value << report.frames;
+    out << YAML::Key << "agreement" << YAML::Value << report.agreement;
+    if (report.labelAccuracy >= 0) {
+        out << YAML::Key << "label_accuracy" << YAML::Value << report.labelAccuracy;
+    }
+    out << YAML::Key << "recall" << YAML::Value << report.recall;
+    out << YAML::Key << "precision" << YAML::Value << report.precision;
+    out << YAML::Key << "mean_iou" << YAML::Value << report.meanIou;
+    out << YAML::Key << "mean_score_delta" << YAML::Value << report.meanScoreDelta;
+    out << YAML::Key << "fp32_latency_ms" << YAML::Value << report.fp32LatencyMs;
+    out << YAML::Key << "int8_latency_ms" << YAML::Value << report.int8LatencyMs;
+    out << YAML::EndMap;
+
+    ofstream file(path);
+    if (!file) return false;
+    file << out.c_str() << endl;
+    return (bool)file;
+}
+
+bool quantization::readReport(const string& path, Report& report) {
+    try {
+        YAML::Node node = YAML::LoadFile(path);
+        report.fp32Model = node["fp32_model"].as<string>(report.fp32Model);
+        report.int8Model = node["int8_model"].as<string>(report.int8Model);
+        report.frames = node["frames"].as<int>(report.frames);
+        report.agreement = node["agreement"].as<double>();
+        report.labelAccuracy = node["label_accuracy"].as<double>(report.labelAccuracy);
+        report.recall = node["recall"].as<double>(report.recall);
+        report.precision = node["precision"].as<double>(report.precision);
+        report.meanIou = node["mean_iou"].as<double>(report.meanIou);
+        report.meanScoreDelta = node["mean_score_delta"].as<double>(report.meanScoreDelta);
+        report.fp32LatencyMs = node["fp32_latency_ms"].as<double>(report.fp32LatencyMs);
+        report.int8LatencyMs = node["int8_latency_ms"].as<double>(report.int8LatencyMs);
+    } catch (const YAML::Exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool quantization::writeNpy(const string& path, const float* data, const vector<int>& shape) {
+    string dims;
+    size_t count = 1;
+    for (int d : shape) {
+        dims += to_string(d) + ", ";
+        count *= (size_t)d;
+    }
+    if (shape.size() > 1) dims.erase(dims.size() - 2);
+    string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + dims + "), }";
+    // 魔数 + 版本 + 长度字段共 10 字节，头部整体补齐到 64 字节并以换行结尾
+    size_t total = 10 + header.size() + 1;
+    header.append((64 - total % 64) % 64, ' ');
+    header += '\n';
+
+    ofstream file(path, ios::binary);
+    if (!file) return false;
+    file.write("\x93NUMPY\x01\x00", 8);
+    unsigned short headerLen = (unsigned short)header.size();
+    char len[2] = {(char)(headerLen & 0xff), (char)(headerLen >> 8)};
+    file.write(len, 2);
+    file.write(header.data(), header.size());
+    file.write(reinterpret_cast<const char*>(data), count * sizeof(float));
+    return (bool)file;
+}
+
+string quantization::reportPathFor(const string& int8Path, const string& reportPath) {
+    return reportPath.empty() ? int8Path + ".report.yaml" : reportPath;
+}
+
+string quantization::selectModel(const string& fp32Path, const string& int8Path,
+                                 const string& reportPath, double minAgreement) {
+    if (int8Path.empty()) {
+        LOG_WARN("未配置 INT8 模型，使用 FP32 模型");
+        return fp32Path;
+    }
+    string path = reportPathFor(int8Path, reportPath);
+    Report report;
+    if (!readReport(path, report)) {
+        LOG_WARN("INT8 模型缺少精度报告 " << path << "，使用 FP32 模型（先运行 calibrate 工具的 evaluate）");
+        return fp32Path;
+    }
+    // 报告必须是对当前这对模型的评估，否则重新量化后旧报告会让未经评估的模型生效
+    if (!samePath(report.int8Model, int8Path) || !samePath(report.fp32Model, fp32Path)) {
+        LOG_WARN("INT8 精度报告 " << path << " 对应的模型（" << report.fp32Model << " / " << report.int8Model
+                 << "）与当前配置不同，使用 FP32 模型（重新运行 calibrate 工具的 evaluate）");
+        return fp32Path;
+    }
+    if (modifiedTime(int8Path) > modifiedTime(path)) {
+        LOG_WARN("INT8 模型 " << int8Path << " 比精度报告 " << path
+                 << " 新，使用 FP32 模型（重新运行 calibrate 工具的 evaluate）");
+        return fp32Path;
+    }
+    if (report.agreement < minAgreement) {
+        LOG_WARN("INT8 模型与 FP32 的一致率 " << report.agreement << " 低于阈值 " << minAgreement
+                 << "，使用 FP32 模型");
+        return fp32Path;
+    }
+    LOG_INFO("使用 INT8 模型 " << int8Path << "（一致率 " << report.agreement
+             << "，延迟 " << report.fp32LatencyMs << " -> " << report.int8LatencyMs << " ms）");
+    return int8Path;
+}
@@ -0,0 +1,65 @@
+#include "result_stream.h"
+#include <chrono>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+// 名称可能来自配置文件，输出前转义
+void appendJsonString(ostringstream& out, const string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+}
+
+ResultStream::ResultStream(const Config& config) : config_(config) {
+    if (config_.enable && !writer_.start(config_.path, config_.ringCapacity, 100)) {
+        config_.enable = false;
+    }
+}
+
+ResultStream::~ResultStream() {
+    stop();
+}
+
+void ResultStream::stop() {
+    writer_.stop();
+}
+
+bool ResultStream::due(bool changed, double sinceLastMs) const {
+    if (!config_.enable) return false;
+    if (config_.onChange && changed) return true;
+    return config_.intervalMs > 0 && sinceLastMs >= config_.intervalMs;
+}
+
+void ResultStream::emit(const Record& record) {
+    if (!config_.enable) return;
+
+    int64_t wallMs = chrono::duration_cast<chrono::milliseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    ostringstream out;
+    out << "{\"wall_ms\":" << wallMs << ",\"stream\":";
+    appendJsonString(out, record.stream);
+    out << ",\"frame\":" << record.frame
+        << ",\"ts_ms\":" << (int64_t)record.timestampMs
+        << ",\"status\":\"" << record.status << "\",\"color\":\"" << record.color << "\",\"timers\":{";
+    for (size_t i = 0; i < record.timers.size(); ++i) {
+        if (i > 0) out << ',';
+        appendJsonString(out, record.timers[i].first);
+        out << ':';
+        appendJsonString(out, record.timers[i].second);
+    }
+    out << "}}";
+
+    // 超长的记录截断后不是合法 JSON，直接丢弃并计数
+    writer_.write(out.str(), false);
+}
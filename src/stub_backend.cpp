@@ -0,0 +1,72 @@
+#include "stub_backend.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+using namespace std;
+
+StubBackend::StubBackend(const Config& config, vector<int64_t> inputShape,
+                         vector<int64_t> imageOutputShape, vector<float> imageOutput)
+    : config_(config), inputShape_(std::move(inputShape)),
+      imageOutputShape_(std::move(imageOutputShape)), imageOutput_(std::move(imageOutput)) {}
+
+float* StubBackend::prepareInput(const vector<int64_t>& shape) {
+    batchSize_ = shape.empty() ? 1 : shape[0];
+    size_t size = accumulate(shape.begin(), shape.end(), (size_t)1, multiplies<size_t>());
+    if (inputBuffer_.size() < size) {
+        inputBuffer_.resize(size);
+    }
+    return inputBuffer_.data();
+}
+
+const float* StubBackend::run(vector<int64_t>& outputShape) {
+    double delayMs = config_.delayMs + config_.itemDelayMs * batchSize_;
+    if (delayMs > 0) {
+        this_thread::sleep_for(chrono::microseconds((int64_t)(delayMs * 1000)));
+    }
+
+    // batch 变化时才重新复制输出
+    if (outputBatchSize_ != batchSize_) {
+        outputBuffer_.resize(imageOutput_.size() * batchSize_);
+        for (int64_t i = 0; i < batchSize_; ++i) {
+            copy(imageOutput_.begin(), imageOutput_.end(), outputBuffer_.begin() + i * imageOutput_.size());
+        }
+        outputBatchSize_ = batchSize_;
+    }
+    outputShape.assign(1, batchSize_);
+    outputShape.insert(outputShape.end(), imageOutputShape_.begin(), imageOutputShape_.end());
+    return outputBuffer_.data();
+}
+
+vector<float> StubBackend::detectionHead(int numClasses, int numAnchors, int classId,
+                                         float cx, float cy, float w, float h) {
+    vector<float> output((size_t)(4 + numClasses) * numAnchors, 0.0f);
+    const int duplicates = 4;
+    for (int k = 0; k < duplicates && k < numAnchors; ++k) {
+        int a = (int)((int64_t)numAnchors * (k + 1) / (duplicates + 1));
+        output[0 * (size_t)numAnchors + a] = cx + k;
+        output[1 * (size_t)numAnchors + a] = cy - k;
+        output[2 * (size_t)numAnchors + a] = w;
+        output[3 * (size_t)numAnchors + a] = h;
+        output[(size_t)(4 + classId) * numAnchors + a] = 0.9f - 0.05f * k;
+    }
+    return output;
+}
+
+vector<float> StubBackend::ctcProbabilities(const vector<string>& labels, const string& text, int timeSteps) {
+    int numClasses = (int)labels.size();
+    vector<float> probs((size_t)timeSteps * numClasses, 0.0f);
+    for (int t = 0; t < timeSteps; ++t) {
+        probs[(size_t)t * numClasses] = 1.0f;  // blank
+    }
+    // 字符放在奇数时间步，相邻相同字符之间有 blank，不会被 CTC 合并
+    for (size_t i = 0; i < text.size() && (int)(2 * i + 1) < timeSteps; ++i) {
+        auto it = find(labels.begin() + 1, labels.end(), string(1, text[i]));
+        if (it == labels.end()) continue;
+        size_t row = (2 * i + 1) * numClasses;
+        probs[row] = 0.0f;
+        probs[row + (it - labels.begin())] = 1.0f;
+    }
+    return probs;
+}
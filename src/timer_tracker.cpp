@@ -0,0 +1,84 @@
+#include "timer_tracker.h"
+#include <cmath>
+#include <cctype>
+
+namespace {
+// 仅由数字组成的读数才视为倒计时数值
+bool parseTimerValue(const std::string& reading, int& value) {
+    if (reading.empty() || reading.size() > 3) return false;
+    for (char c : reading) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    }
+    value = std::stoi(reading);
+    return true;
+}
+}
+
+int TimerTracker::predictValue(double timestampMs) const {
+    int steps = (int)std::floor((timestampMs - anchorMs_) / config_.periodMs);
+    return anchorValue_ - steps;
+}
+
+void TimerTracker::lock(int value, double transitionMs) {
+    locked_ = true;
+    anchorValue_ = value;
+    anchorMs_ = transitionMs;
+}
+
+bool TimerTracker::shouldRunOcr(double timestampMs) const {
+    if (!config_.enable || !locked_) return true;
+
+    // 周期性校验
+    if (timestampMs - lastOcrMs_ >= config_.verifyIntervalMs) return true;
+
+    // 即将减到 0 或换相，下一个值不可预测
+    if (predictValue(timestampMs) <= 1) return true;
+
+    // 处于预计跳变时刻附近
+    double phase = std::fmod(timestampMs - anchorMs_, config_.periodMs);
+    if (phase < 0) phase += config_.periodMs;
+    return phase <= config_.transitionWindowMs ||
+           config_.periodMs - phase <= config_.transitionWindowMs;
+}
+
+std::string TimerTracker::update(double timestampMs, const std::string& reading) {
+    ocrRuns_++;
+    int value = 0;
+    if (!parseTimerValue(reading, value)) {
+        // 读数无效，退回逐帧 OCR
+        locked_ = false;
+        hasLastReading_ = false;
+        lastOcrMs_ = timestampMs;
+        return reading;
+    }
+
+    // 相邻两次 OCR 间隔足够短且恰好减一，用中点估计跳变时刻
+    bool decremented = hasLastReading_ && value == lastValue_ - 1 &&
+                       timestampMs - lastOcrMs_ <= config_.maxAnchorGapMs;
+
+    if (locked_) {
+        int predicted = predictValue(timestampMs);
+        if (decremented) {
+            lock(value, (lastOcrMs_ + timestampMs) / 2);
+        } else if (value == predicted + 1 && hasLastReading_ && value == lastValue_) {
+            // 预计跳变时刻已过但显示尚未跳变，推迟锚点
+            lock(value, timestampMs - config_.periodMs + config_.transitionWindowMs);
+        } else if (value != predicted) {
+            locked_ = false;
+        }
+    } else if (decremented) {
+        lock(value, (lastOcrMs_ + timestampMs) / 2);
+    }
+
+    // 统一输出不带前导零的数值，与 predict 一致，显示 "09" 时校验帧和预测帧的读数不会来回变化
+    hasLastReading_ = true;
+    lastValue_ = value;
+    lastOcrMs_ = timestampMs;
+    lastReading_ = std::to_string(value);
+    return lastReading_;
+}
+
+std::string TimerTracker::predict(double timestampMs) {
+    ocrSkips_++;
+    return locked_ ? std::to_string(predictValue(timestampMs)) : lastReading_;
+}
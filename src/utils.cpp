@@ -13,6 +13,47 @@ using namespace std;
 // 初始化状态变量
 TrafficSignalStatus currentStatus = TrafficSignalStatus::Normal;
 
+Mat cropROI(const Mat& frame, const Rect& roi) {
+    return roi.area() > 0 ? frame(roi & Rect(0, 0, frame.cols, frame.rows)) : frame;
+}
+
+vector<Mat> cropROIs(const Mat& frame, const vector<Rect>& rois) {
+    vector<Mat> crops;
+    if (rois.empty()) {
+        crops.push_back(frame);
+    }
+    for (const Rect& roi : rois) {
+        Mat crop = cropROI(frame, roi);
+        if (!crop.empty()) crops.push_back(crop);
+    }
+    return crops;
+}
+
+int sampleVideos(const vector<string>& videos, int samples, int stride,
+                 const function<int(const Mat&, const string&, int, int)>& visit) {
+    if (videos.empty()) return 0;
+    int perVideo = (samples + (int)videos.size() - 1) / (int)videos.size();
+    int written = 0;
+    for (const string& video : videos) {
+        VideoCapture cap(video);
+        if (!cap.isOpened()) {
+            cerr << "Error: Cannot open the video " << video << endl;
+            return -1;
+        }
+        int taken = 0;
+        Mat frame;
+        for (int index = 0; taken < perVideo && written < samples && cap.read(frame); ++index) {
+            if (index % stride != 0) continue;
+            int used = visit(frame, video, index, min(perVideo - taken, samples - written));
+            if (used < 0) return -1;
+            taken += used;
+            written += used;
+        }
+        cout << video << ": " << taken << " 个样本" << endl;
+    }
+    return written;
+}
+
 std::vector<std::string> ReadDict(const std::string &path) noexcept {
     std::vector<std::string> m_vec;
     std::ifstream in(path);
@@ -46,53 +87,233 @@ std::string parseCommandLineArgs(int argc, char* argv[], const std::string& defa
     return configPath;
 }
 
+namespace {
+
+// 读取单个区域：x/y/width/height，可选 name 和 light（计时区域所属的信号灯区域）
+RegionOfInterest readROI(const YAML::Node& node, const string& defaultName) {
+    RegionOfInterest roi;
+    roi.name = node["name"].as<string>(defaultName);
+    roi.rect.x = node["x"].as<int>();
+    roi.rect.y = node["y"].as<int>();
+    roi.rect.width = node["width"].as<int>();
+    roi.rect.height = node["height"].as<int>();
+    roi.light = node["light"].as<string>("");
+    return roi;
+}
+
+vector<RegionOfInterest> readROIList(const YAML::Node& node, const string& prefix) {
+    vector<RegionOfInterest> rois;
+    for (size_t i = 0; i < node.size(); ++i) {
+        rois.push_back(readROI(node[i], prefix + to_string(i)));
+    }
+    return rois;
+}
+
+// 桩后端配置：固定延迟、每张图像的追加延迟和 OCR 输出文本
+void readStub(const YAML::Node& node, StubBackend::Config& stub) {
+    if (!node) return;
+    stub.delayMs = node["delay_ms"].as<double>(stub.delayMs);
+    stub.itemDelayMs = node["item_delay_ms"].as<double>(stub.itemDelayMs);
+    stub.text = node["text"].as<string>(stub.text);
+}
+
+} // namespace
+
 bool loadConfig(const string& configPath, 
                string& videoSource,
                YOLOWrapper::Config& yoloConfig,
                OCRWrapper::Config& ocrConfig,
-               Rect& signalLightROI,
-               Rect& timerROI,
                bool& enableVideoOutput,
                string& videoOutputPath,
                string& videoCodec,
-               int& videoFps) {
+               int& videoFps,
+               FramePipeline::Config& pipelineConfig) {
     try {
         YAML::Node config = YAML::LoadFile(configPath);
 
-        videoSource = config["video_source"].as<string>();
+        videoSource = config["video_source"].as<string>("");
 
         // 加载 YOLO 配置
         auto yoloNode = config["yolo_config"];
-        yoloConfig.modelPath = yoloNode["model_path"].as<string>();
+        yoloConfig.modelPath = yoloNode["model_path"].as<string>("");
         yoloConfig.confThreshold = yoloNode["conf_threshold"].as<float>();
         yoloConfig.iouThreshold = yoloNode["iou_threshold"].as<float>();
         yoloConfig.intraOpNumThreads = yoloNode["num_threads"].as<int>();
+        yoloConfig.head = yoloNode["head"].as<string>(yoloConfig.head);
+        yoloConfig.classAgnosticNms = yoloNode["class_agnostic_nms"].as<bool>(yoloConfig.classAgnosticNms);
+        yoloConfig.nmsTopK = yoloNode["nms_top_k"].as<int>(yoloConfig.nmsTopK);
+        yoloConfig.maxDetections = yoloNode["max_detections"].as<int>(yoloConfig.maxDetections);
+        yoloConfig.backend = yoloNode["backend"].as<string>(yoloConfig.backend);
+        readStub(yoloNode["stub"], yoloConfig.stub);
+        if (yoloNode["int8"]) {
+            auto int8Node = yoloNode["int8"];
+            yoloConfig.int8ModelPath = int8Node["model_path"].as<string>(yoloConfig.int8ModelPath);
+            yoloConfig.int8ReportPath = int8Node["report"].as<string>(yoloConfig.int8ReportPath);
+            yoloConfig.int8MinAgreement = int8Node["min_agreement"].as<double>(yoloConfig.int8MinAgreement);
+        }
 
         // 加载 OCR 配置
         auto ocrNode = config["ocr_config"];
-        ocrConfig.modelPath = ocrNode["model_dir"].as<string>();
+        ocrConfig.modelPath = ocrNode["model_dir"].as<string>("");
         ocrConfig.intraOpNumThreads = ocrNode["intra_op_num_threads"].as<int>();
-        ocrConfig.useMkldnn = ocrNode["use_mkldnn"].as<bool>();
+        ocrConfig.useMkldnn = ocrNode["use_mkldnn"].as<bool>(ocrConfig.useMkldnn);
         ocrConfig.recBatchNum = ocrNode["rec_batch_num"].as<int>();
         ocrConfig.recImgH = ocrNode["rec_img_h"].as<int>();
         ocrConfig.recImgW = ocrNode["rec_img_w"].as<int>();
-        ocrConfig.dictPath = ocrNode["dict_path"].as<string>();
+        ocrConfig.dictPath = ocrNode["dict_path"].as<string>("");
+        ocrConfig.charset = ocrNode["charset"].as<string>(ocrConfig.charset);
+        ocrConfig.backend = ocrNode["backend"].as<string>(ocrConfig.backend);
+        ocrConfig.onnxModelPath = ocrNode["onnx_model_path"].as<string>(ocrConfig.onnxModelPath);
+        ocrConfig.precision = ocrNode["precision"].as<string>(ocrConfig.precision);
+        if (ocrNode["int8"]) {
+            auto int8Node = ocrNode["int8"];
+            ocrConfig.int8ModelDir = int8Node["model_dir"].as<string>(ocrConfig.int8ModelDir);
+            ocrConfig.int8ReportPath = int8Node["report"].as<string>(ocrConfig.int8ReportPath);
+            ocrConfig.int8MinAgreement = int8Node["min_agreement"].as<double>(ocrConfig.int8MinAgreement);
+        }
+        readStub(ocrNode["stub"], ocrConfig.stub);
+        if (ocrNode["cache"]) {
+            auto cacheNode = ocrNode["cache"];
+            ocrConfig.cacheEnable = cacheNode["enable"].as<bool>(ocrConfig.cacheEnable);
+            ocrConfig.cacheTolerance = cacheNode["tolerance"].as<int>(ocrConfig.cacheTolerance);
+            ocrConfig.cacheThumbSize = cacheNode["thumb_size"].as<int>(ocrConfig.cacheThumbSize);
+            ocrConfig.cacheCapacity = cacheNode["capacity"].as<int>(ocrConfig.cacheCapacity);
+        }
+        if (ocrNode["bucket"]) {
+            auto bucketNode = ocrNode["bucket"];
+            ocrConfig.bucketEnable = bucketNode["enable"].as<bool>(ocrConfig.bucketEnable);
+            ocrConfig.bucketWidths = bucketNode["widths"].as<vector<int>>(ocrConfig.bucketWidths);
+            ocrConfig.bucketBatchSizes = bucketNode["batch_sizes"].as<vector<int>>(ocrConfig.bucketBatchSizes);
+            ocrConfig.bucketWarmup = bucketNode["warmup"].as<bool>(ocrConfig.bucketWarmup);
+        }
         
-        signalLightROI.x = config["signalLightROI"]["x"].as<int>();
-        signalLightROI.y = config["signalLightROI"]["y"].as<int>();
-        signalLightROI.width = config["signalLightROI"]["width"].as<int>();
-        signalLightROI.height = config["signalLightROI"]["height"].as<int>();
-
-        timerROI.x = config["timerROI"]["x"].as<int>();
-        timerROI.y = config["timerROI"]["y"].as<int>();
-        timerROI.width = config["timerROI"]["width"].as<int>();
-        timerROI.height = config["timerROI"]["height"].as<int>();
+        // 多区域配置优先，未配置时兼容单个 signalLightROI / timerROI
+        if (config["light_rois"]) {
+            pipelineConfig.lightROIs = readROIList(config["light_rois"], "light");
+        } else {
+            pipelineConfig.lightROIs = {readROI(config["signalLightROI"], "light")};
+        }
+        if (config["timer_rois"]) {
+            pipelineConfig.timerROIs = readROIList(config["timer_rois"], "timer");
+        } else {
+            pipelineConfig.timerROIs = {readROI(config["timerROI"], "timer")};
+        }
 
         enableVideoOutput = config["video_output"]["enable"].as<bool>();
         videoOutputPath = config["video_output"]["path"].as<string>();
         videoCodec = config["video_output"]["codec"].as<string>();
         videoFps = config["video_output"]["fps"].as<int>();
+        VideoEncoder::Config& encoderConfig = pipelineConfig.videoEncoder;
+        encoderConfig.queueCapacity = config["video_output"]["queue_capacity"].as<int>(encoderConfig.queueCapacity);
+        encoderConfig.overflowPolicy = config["video_output"]["overflow_policy"].as<string>(encoderConfig.overflowPolicy);
+        encoderConfig.downscale = config["video_output"]["downscale"].as<double>(encoderConfig.downscale);
+
+        // 异常阈值（可选）
+        if (config["anomaly_thresholds"]) {
+            auto anomalyNode = config["anomaly_thresholds"];
+            pipelineConfig.signalAnomalyThreshold = anomalyNode["signal"].as<int>(pipelineConfig.signalAnomalyThreshold);
+            pipelineConfig.ocrAnomalyThreshold = anomalyNode["ocr"].as<int>(pipelineConfig.ocrAnomalyThreshold);
+        }
 
+        // 流水线配置（可选）
+        if (config["pipeline"]) {
+            auto pipelineNode = config["pipeline"];
+            pipelineConfig.queueCapacity = pipelineNode["queue_capacity"].as<int>(pipelineConfig.queueCapacity);
+            pipelineConfig.reportInterval = pipelineNode["report_interval"].as<int>(pipelineConfig.reportInterval);
+            pipelineConfig.display = pipelineNode["display"].as<bool>(pipelineConfig.display);
+            pipelineConfig.maxBatchFrames = pipelineNode["max_batch_frames"].as<int>(pipelineConfig.maxBatchFrames);
+            pipelineConfig.captureMode = pipelineNode["capture_mode"].as<string>(pipelineConfig.captureMode);
+            pipelineConfig.captureRingSize = pipelineNode["capture_ring_size"].as<int>(pipelineConfig.captureRingSize);
+        }
+        // 调试帧转储（可选）
+        if (config["debug_dump"]) {
+            auto dumpNode = config["debug_dump"];
+            FrameDumper::Config& dumpConfig = pipelineConfig.frameDump;
+            dumpConfig.enable = dumpNode["enable"].as<bool>(dumpConfig.enable);
+            dumpConfig.outputDir = dumpNode["output_dir"].as<string>(dumpConfig.outputDir);
+            dumpConfig.sampleInterval = dumpNode["sample_interval"].as<int>(dumpConfig.sampleInterval);
+            dumpConfig.onTransition = dumpNode["on_transition"].as<bool>(dumpConfig.onTransition);
+            dumpConfig.onAnomaly = dumpNode["on_anomaly"].as<bool>(dumpConfig.onAnomaly);
+            dumpConfig.queueCapacity = dumpNode["queue_capacity"].as<int>(dumpConfig.queueCapacity);
+            dumpConfig.jpegQuality = dumpNode["jpeg_quality"].as<int>(dumpConfig.jpegQuality);
+        }
+        // 结构化结果流（可选）
+        if (config["result_stream"]) {
+            auto resultNode = config["result_stream"];
+            ResultStream::Config& resultConfig = pipelineConfig.resultStream;
+            resultConfig.enable = resultNode["enable"].as<bool>(resultConfig.enable);
+            resultConfig.path = resultNode["path"].as<string>(resultConfig.path);
+            resultConfig.onChange = resultNode["on_change"].as<bool>(resultConfig.onChange);
+            resultConfig.intervalMs = resultNode["interval_ms"].as<double>(resultConfig.intervalMs);
+        }
+        // 日志（可选）
+        if (config["logging"]) {
+            auto loggingNode = config["logging"];
+            Logger::Config& loggerConfig = pipelineConfig.logger;
+            loggerConfig.level = loggingNode["level"].as<string>(loggerConfig.level);
+            loggerConfig.file = loggingNode["file"].as<string>(loggerConfig.file);
+            loggerConfig.ringCapacity = loggingNode["ring_capacity"].as<int>(loggerConfig.ringCapacity);
+        }
+        // 性能指标导出（可选）
+        if (config["metrics"]) {
+            auto metricsNode = config["metrics"];
+            Metrics::Config& metricsConfig = pipelineConfig.metrics;
+            metricsConfig.enable = metricsNode["enable"].as<bool>(metricsConfig.enable);
+            metricsConfig.bindAddress = metricsNode["bind"].as<string>(metricsConfig.bindAddress);
+            metricsConfig.httpPort = metricsNode["http_port"].as<int>(metricsConfig.httpPort);
+            metricsConfig.file = metricsNode["file"].as<string>(metricsConfig.file);
+            metricsConfig.fileIntervalMs = metricsNode["file_interval_ms"].as<int>(metricsConfig.fileIntervalMs);
+        }
+        // 推理后端对比（可选），以 --compare-backends 启动时使用
+        if (config["backend_compare"]) {
+            auto compareNode = config["backend_compare"];
+            backend_compare::Config& compareConfig = pipelineConfig.backendCompare;
+            compareConfig.frames = compareNode["frames"].as<int>(compareConfig.frames);
+            compareConfig.warmup = compareNode["warmup"].as<int>(compareConfig.warmup);
+            compareConfig.yoloBackends = compareNode["yolo"].as<vector<string>>(compareConfig.yoloBackends);
+            compareConfig.ocrBackends = compareNode["ocr"].as<vector<string>>(compareConfig.ocrBackends);
+        }
+        // 多路视频流（可选），配置后忽略 video_source
+        if (config["streams"]) {
+            auto streamsNode = config["streams"];
+            for (size_t i = 0; i < streamsNode.size(); ++i) {
+                auto streamNode = streamsNode[i];
+                StreamConfig stream;
+                stream.name = streamNode["name"].as<string>("stream" + to_string(i));
+                stream.source = streamNode["source"].as<string>();
+                stream.videoOutputPath = streamNode["video_output"].as<string>("");
+                if (streamNode["light_rois"]) {
+                    stream.lightROIs = readROIList(streamNode["light_rois"], "light");
+                }
+                if (streamNode["timer_rois"]) {
+                    stream.timerROIs = readROIList(streamNode["timer_rois"], "timer");
+                }
+                pipelineConfig.streams.push_back(stream);
+            }
+        }
+        // 倒计时跟踪配置（可选）
+        if (config["timer_tracker"]) {
+            auto trackerNode = config["timer_tracker"];
+            TimerTracker::Config& trackerConfig = pipelineConfig.timerTracker;
+            trackerConfig.enable = trackerNode["enable"].as<bool>(trackerConfig.enable);
+            trackerConfig.clock = trackerNode["clock"].as<string>(trackerConfig.clock);
+            trackerConfig.periodMs = trackerNode["period_ms"].as<double>(trackerConfig.periodMs);
+            trackerConfig.transitionWindowMs = trackerNode["transition_window_ms"].as<double>(trackerConfig.transitionWindowMs);
+            trackerConfig.verifyIntervalMs = trackerNode["verify_interval_ms"].as<double>(trackerConfig.verifyIntervalMs);
+            trackerConfig.maxAnchorGapMs = trackerNode["max_anchor_gap_ms"].as<double>(trackerConfig.maxAnchorGapMs);
+        }
+        // 关键帧检测调度配置（可选）
+        if (config["detection_scheduler"]) {
+            auto schedulerNode = config["detection_scheduler"];
+            DetectionScheduler::Config& schedulerConfig = pipelineConfig.detectionScheduler;
+            schedulerConfig.enable = schedulerNode["enable"].as<bool>(schedulerConfig.enable);
+            schedulerConfig.minInterval = schedulerNode["min_interval"].as<int>(schedulerConfig.minInterval);
+            schedulerConfig.maxInterval = schedulerNode["max_interval"].as<int>(schedulerConfig.maxInterval);
+            schedulerConfig.confTrigger = schedulerNode["conf_trigger"].as<float>(schedulerConfig.confTrigger);
+            schedulerConfig.motionTrigger = schedulerNode["motion_trigger"].as<float>(schedulerConfig.motionTrigger);
+            schedulerConfig.stableIou = schedulerNode["stable_iou"].as<float>(schedulerConfig.stableIou);
+            schedulerConfig.colorCheck = schedulerNode["color_check"].as<bool>(schedulerConfig.colorCheck);
+        }
         return true;
     } catch (const YAML::Exception& e) {
         cerr << "配置文件加载失败: " << e.what() << endl;
@@ -156,21 +377,21 @@ void drawStatusInfo(cv::Mat& frame,
         case TrafficSignalStatus::Normal:
             statusText = " Status: [Normal] " + englishColor + " Light | Time Left: " + timerValue + "s";
             color = cv::Scalar(0, 255, 0); // 绿色
-            std::cout << "状态: 正常 - " << colorName << "灯亮 剩余时间: " << timerValue << "秒" << std::endl;
+            LOG_DEBUG("状态: 正常 - " << colorName << "灯亮 剩余时间: " << timerValue << "秒");
             break;
         case TrafficSignalStatus::SignalMissing:
             statusText = " Status: [Alert] No Traffic Light Detected";
             color = cv::Scalar(0, 0, 255); // 红色
-            std::cout << "状态: [警告] - 未检测到信号灯，信号灯工作异常" << std::endl;
+            LOG_DEBUG("状态: [警告] - 未检测到信号灯，信号灯工作异常");
             break;
         case TrafficSignalStatus::TimerMissing:
             statusText = " Status: [Alert] Light On But No Timer";
             color = cv::Scalar(0, 255, 255); // 黄色
-            std::cout << "状态: [警告] - 检测到信号灯，未检测到计时数字，信号灯超时" << std::endl;
+            LOG_DEBUG("状态: [警告] - 检测到信号灯，未检测到计时数字，信号灯超时");
             break;
     }
 
-    std::cout << "绘制状态信息: " << statusText << std::endl;
+    LOG_DEBUG("绘制状态信息: " << statusText);
     // 绘制文字
     int baseline;
     cv::Size textSize = cv::getTextSize(statusText, cv::FONT_HERSHEY_SIMPLEX, 1.2, 3, &baseline);
@@ -0,0 +1,106 @@
+#include "video_encoder.h"
+#include <iostream>
+#include "metrics.h"
+
+using namespace cv;
+using namespace std;
+
+VideoEncoder::VideoEncoder(const Config& config)
+    : config_(config), queue_(config.queueCapacity) {
+    dropWhenFull_ = config_.overflowPolicy == "drop" || config_.overflowPolicy == "downscale";
+    scaled_ = config_.overflowPolicy == "downscale" && config_.downscale > 0 && config_.downscale < 1;
+    if (config_.overflowPolicy != "block" && !dropWhenFull_) {
+        cerr << "Warning: unknown overflow policy " << config_.overflowPolicy << ", using block" << endl;
+    }
+}
+
+VideoEncoder::~VideoEncoder() {
+    release();
+}
+
+bool VideoEncoder::open(const string& path, int fourcc, double fps, Size frameSize) {
+    outputSize_ = frameSize;
+    if (scaled_) {
+        outputSize_ = Size(cvRound(frameSize.width * config_.downscale),
+                           cvRound(frameSize.height * config_.downscale));
+    }
+    if (!writer_.open(path, fourcc, fps, outputSize_)) {
+        return false;
+    }
+    thread_ = thread(&VideoEncoder::encodeLoop, this);
+    return true;
+}
+
+Mat& VideoEncoder::acquireBuffer() {
+    // 队列中的帧加上正在编码的一帧都可能持有缓冲区，池大小取容量 + 2 即可保证总能取到空闲的
+    if (buffers_.empty()) {
+        buffers_.resize(queue_.capacity() + 2);
+    }
+    for (size_t n = 0; n < buffers_.size(); ++n) {
+        Mat& buffer = buffers_[nextBuffer_];
+        nextBuffer_ = (nextBuffer_ + 1) % buffers_.size();
+        // 编码线程释放缓冲区时原子递减引用计数，这里也需原子读取
+        if (!buffer.u || CV_XADD(&buffer.u->refcount, 0) <= 1) {
+            return buffer;
+        }
+    }
+    // 理论上不会发生，放弃旧缓冲区重新分配
+    Mat& buffer = buffers_[nextBuffer_];
+    buffer.release();
+    return buffer;
+}
+
+bool VideoEncoder::write(const Mat& frame) {
+    if (!writer_.isOpened()) return false;
+
+    Job job;
+    job.submitTime = chrono::steady_clock::now();
+    if (scaled_) {
+        if (queue_.size() >= queue_.capacity()) {
+            dropped_++;
+            return false;
+        }
+        Mat& buffer = acquireBuffer();
+        resize(frame, buffer, outputSize_, 0, 0, INTER_AREA);
+        job.frame = buffer;
+    } else {
+        job.frame = frame;
+    }
+
+    bool queued = dropWhenFull_ ? queue_.tryPush(std::move(job)) : queue_.push(std::move(job));
+    if (!queued) {
+        dropped_++;
+    }
+    return queued;
+}
+
+void VideoEncoder::encodeLoop() {
+    Job job;
+    // 关闭后仍会写完队列中剩余的帧
+    while (queue_.pop(job)) {
+        {
+            METRICS_SCOPE("encode");
+            writer_.write(job.frame);
+        }
+        job.frame.release();
+
+        int64_t lagUs = chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now() - job.submitTime).count();
+        lagUsSum_ += lagUs;
+        int64_t maxLag = maxLagUs_;
+        while (lagUs > maxLag && !maxLagUs_.compare_exchange_weak(maxLag, lagUs)) {}
+        written_++;
+    }
+}
+
+void VideoEncoder::release() {
+    lock_guard<mutex> lock(releaseMutex_);
+    queue_.close();
+    if (thread_.joinable()) thread_.join();
+    if (writer_.isOpened()) writer_.release();
+}
+
+double VideoEncoder::averageLagMs() const {
+    uint64_t frames = written_;
+    return frames ? lagUsSum_ / 1000.0 / frames : 0.0;
+}
@@ -0,0 +1,152 @@
+#include "yolo_decoder.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+
+namespace yolo_decoder {
+
+namespace {
+// 中心点格式转为左上角格式的候选框
+inline void emitCandidate(float cx, float cy, float w, float h, float conf, int classId,
+                          std::vector<Detection>& candidates) {
+    int centerX = (int)cx;
+    int centerY = (int)cy;
+    int width = (int)w;
+    int height = (int)h;
+    Detection det;
+    det.box = cv::Rect(centerX - width / 2, centerY - height / 2, width, height);
+    det.confidence = conf;
+    det.classId = classId;
+    candidates.push_back(det);
+}
+
+// V8 布局：类别分数按通道连续存放，沿 anchor 方向向量化求最大类别并做阈值判断
+// NC > 0 时类别数为编译期常量，NC == 0 时使用 params.numClasses
+template <int NC>
+void decodeV8(const float* output, const Params& params, std::vector<Detection>& candidates) {
+    const int numClasses = NC > 0 ? NC : params.numClasses;
+    const int numAnchors = params.numAnchors;
+    const float threshold = params.confThreshold;
+    const float* cx = output;
+    const float* cy = output + numAnchors;
+    const float* w = output + 2 * numAnchors;
+    const float* h = output + 3 * numAnchors;
+    const float* scores = output + 4 * numAnchors;
+
+    int a = 0;
+#if CV_SIMD128
+    const cv::v_float32x4 vthreshold = cv::v_setall_f32(threshold);
+    for (; a <= numAnchors - 4; a += 4) {
+        cv::v_float32x4 best = cv::v_load(scores + a);
+        cv::v_int32x4 bestId = cv::v_setzero_s32();
+        for (int c = 1; c < numClasses; c++) {
+            cv::v_float32x4 v = cv::v_load(scores + (size_t)c * numAnchors + a);
+            cv::v_float32x4 greater = v > best;
+            best = cv::v_select(greater, v, best);
+            bestId = cv::v_select(cv::v_reinterpret_as_s32(greater), cv::v_setall_s32(c), bestId);
+        }
+        int mask = cv::v_signmask(best > vthreshold);
+        if (mask == 0) continue;
+
+        float bestBuf[4];
+        int idBuf[4];
+        cv::v_store(bestBuf, best);
+        cv::v_store(idBuf, bestId);
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                int i = a + lane;
+                emitCandidate(cx[i], cy[i], w[i], h[i], bestBuf[lane], idBuf[lane], candidates);
+            }
+        }
+    }
+#endif
+    for (; a < numAnchors; a++) {
+        float best = scores[a];
+        int bestId = 0;
+        for (int c = 1; c < numClasses; c++) {
+            float v = scores[(size_t)c * numAnchors + a];
+            if (v > best) {
+                best = v;
+                bestId = c;
+            }
+        }
+        if (best > threshold) {
+            emitCandidate(cx[a], cy[a], w[a], h[a], best, bestId, candidates);
+        }
+    }
+}
+
+// V5 布局：每个 anchor 的数据连续存放，先用 objectness 提前排除，再求最大类别
+template <int NC>
+void decodeV5(const float* output, const Params& params, std::vector<Detection>& candidates) {
+    const int numClasses = NC > 0 ? NC : params.numClasses;
+    const int stride = 5 + numClasses;
+    const float threshold = params.confThreshold;
+
+    for (int a = 0; a < params.numAnchors; a++) {
+        const float* row = output + (size_t)a * stride;
+        float objectness = row[4];
+        if (objectness <= threshold) continue;
+
+        const float* scores = row + 5;
+        float best = scores[0];
+        int bestId = 0;
+        for (int c = 1; c < numClasses; c++) {
+            if (scores[c] > best) {
+                best = scores[c];
+                bestId = c;
+            }
+        }
+        float conf = objectness * best;
+        if (conf > threshold) {
+            emitCandidate(row[0], row[1], row[2], row[3], conf, bestId, candidates);
+        }
+    }
+}
+
+template <int NC>
+void decodeLayout(const float* output, const Params& params, std::vector<Detection>& candidates) {
+    if (params.layout == HeadLayout::V5) {
+        decodeV5<NC>(output, params, candidates);
+    } else {
+        decodeV8<NC>(output, params, candidates);
+    }
+}
+}
+
+Params resolveParams(const std::string& head, int dim1, int dim2, float confThreshold) {
+    Params params;
+    params.confThreshold = confThreshold;
+    if (head == "v5") {
+        params.layout = HeadLayout::V5;
+    } else if (head == "v8" || head == "v11") {
+        params.layout = HeadLayout::V8;
+    } else {
+        // auto：anchor 数远大于通道数，较长的维度即为 anchor 维
+        if (head != "auto") {
+            std::cerr << "Unknown YOLO head type: " << head << ", fallback to auto" << std::endl;
+        }
+        params.layout = dim1 < dim2 ? HeadLayout::V8 : HeadLayout::V5;
+    }
+
+    if (params.layout == HeadLayout::V8) {
+        params.numClasses = dim1 - 4;
+        params.numAnchors = dim2;
+    } else {
+        params.numClasses = dim2 - 5;
+        params.numAnchors = dim1;
+    }
+    return params;
+}
+
+void decode(const float* output, const Params& params, std::vector<Detection>& candidates) {
+    switch (params.numClasses) {
+        case 1: decodeLayout<1>(output, params, candidates); break;
+        case 2: decodeLayout<2>(output, params, candidates); break;
+        case 3: decodeLayout<3>(output, params, candidates); break;
+        case 4: decodeLayout<4>(output, params, candidates); break;
+        case 80: decodeLayout<80>(output, params, candidates); break;
+        default: decodeLayout<0>(output, params, candidates); break;
+    }
+}
+
+}
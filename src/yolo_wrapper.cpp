@@ -1,203 +1,150 @@
 #include "yolo_wrapper.h"
 #include <opencv2/opencv.hpp>
-#include <onnxruntime_cxx_api.h>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
 #include "data.h"
+#include "nms.h"
+#include "metrics.h"
+#include "quantization.h"
 
 using namespace cv;
-using namespace Ort;
 using namespace std;
 
-// 初始化 ONNX Runtime 模型
-YOLOWrapper::YOLOWrapper(const Config& config) 
-    : config_(config), env_(ORT_LOGGING_LEVEL_WARNING, "YOLOv8-ONNXRuntime") {
-    
-    sessionOptions_.SetIntraOpNumThreads(config.intraOpNumThreads);
-    sessionOptions_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-
-    // 创建 session
-    session_ = std::make_unique<Ort::Session>(env_, config.modelPath.c_str(), sessionOptions_);
-
-    // 获取输入和输出节点数量
-    const size_t num_input_nodes = session_->GetInputCount();
-    const size_t num_output_nodes = session_->GetOutputCount();
-
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    // 处理输入节点
-    for (size_t i = 0; i < num_input_nodes; i++) {
-        // 获取输入节点名称
-        inputNames_.push_back(session_->GetInputName(i, allocator));
-
-        // 获取输入形状信息
-        Ort::TypeInfo inputTypeInfo = session_->GetInputTypeInfo(i);
-        auto tensor_info = inputTypeInfo.GetTensorTypeAndShapeInfo();
-        inputShape_ = tensor_info.GetShape();
-
-        // 检查是否为动态输入形状
-        isDynamicInputShape_ = false;
-        if (inputShape_[2] == -1 && inputShape_[3] == -1) {
-            std::cout << "Dynamic input shape detected" << std::endl;
-            isDynamicInputShape_ = true;
+// 初始化推理后端，按模型输入形状确定 letterbox 尺寸
+YOLOWrapper::YOLOWrapper(const Config& config) : config_(config) {
+    if (config.backend == "stub") {
+        // 桩后端：固定 640x640 输入、3 类 v8 检测头，画面中央输出一个框
+        const int numClasses = 3;
+        const int numAnchors = 8400;
+        backend_.reset(new StubBackend(config.stub, {-1, 3, 640, 640}, {4 + numClasses, numAnchors},
+                                       StubBackend::detectionHead(numClasses, numAnchors, 0,
+                                                                  320, 320, 40, 100)));
+    } else {
+        activeModelPath_ = config.modelPath;
+        if (!config.int8ModelPath.empty()) {
+            activeModelPath_ = quantization::selectModel(config.modelPath, config.int8ModelPath,
+                                                         config.int8ReportPath, config.int8MinAgreement);
+        }
+        backend_ = createInferenceBackend(config.backend, activeModelPath_, config.intraOpNumThreads,
+                                          {-1, 3, -1, -1});
+        if (!backend_) {
+            throw std::invalid_argument("unknown YOLO backend: " + config.backend);
         }
     }
+    inputShape_ = backend_->inputShape();
 
-    // 处理输出节点
-    for (size_t i = 0; i < num_output_nodes; i++) {
-        // 获取输出节点名称
-        outputNames_.push_back(session_->GetOutputName(i, allocator));
-
-        // 获取输出形状信息
-        Ort::TypeInfo outputTypeInfo = session_->GetOutputTypeInfo(i);
-        auto tensor_info = outputTypeInfo.GetTensorTypeAndShapeInfo();
-        outputShape_ = tensor_info.GetShape();
+    // 检查是否为动态输入形状
+    if (inputShape_[2] == -1 && inputShape_[3] == -1) {
+        std::cout << "Dynamic input shape detected" << std::endl;
+        isDynamicInputShape_ = true;
     }
+
+    // 检查是否为动态 batch
+    isDynamicBatch_ = inputShape_[0] <= 0;
+
+    nmsOptions_.iouThreshold = config.iouThreshold;
+    nmsOptions_.classAgnostic = config.classAgnosticNms;
+    nmsOptions_.topK = config.nmsTopK;
+    nmsOptions_.maxDetections = config.maxDetections;
+
+    // 动态输入尺寸的模型按默认 640x640 进行 letterbox
+    inputSize_ = isDynamicInputShape_ ? cv::Size(640, 640)
+                                      : cv::Size((int)inputShape_[3], (int)inputShape_[2]);
 }
 
 YOLOWrapper::~YOLOWrapper() {
-    // 清理输入输出名称
-    Ort::AllocatorWithDefaultOptions allocator;
-    for (const char* name : inputNames_) {
-        allocator.Free(const_cast<void*>(static_cast<const void*>(name)));
-    }
-    for (const char* name : outputNames_) {
-        allocator.Free(const_cast<void*>(static_cast<const void*>(name)));
-    }
 }
 
 std::vector<Detection> YOLOWrapper::infer(cv::Mat& frame) {
-    float* blob = nullptr;
-    std::vector<int64_t> inputTensorShape = {1, 3, -1, -1}; // 动态输入形状
-    preprocess(frame, blob, inputTensorShape);
-
-    size_t inputTensorSize = data_utils::vectorProduct(inputTensorShape);
-    std::vector<float> inputTensorValues(blob, blob + inputTensorSize);
-
-    std::vector<Ort::Value> inputTensors;
-    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(
-        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-
-    inputTensors.push_back(Ort::Value::CreateTensor<float>(
-        memoryInfo, inputTensorValues.data(), inputTensorSize,
-        inputTensorShape.data(), inputTensorShape.size()));
-
-    std::vector<Ort::Value> outputTensors = session_->Run(Ort::RunOptions{nullptr},
-                                                          inputNames_.data(),
-                                                          inputTensors.data(),
-                                                          1,
-                                                          outputNames_.data(),
-                                                          outputNames_.size());
-
-    cv::Size resizedShape = cv::Size((int)inputTensorShape[3], (int)inputTensorShape[2]);
-    std::vector<Detection> results = postprocess(resizedShape, frame.size(), outputTensors);
-
-    delete[] blob;
-
-    return results;
+    std::vector<std::vector<Detection>> results;
+    inferBatch(&frame, 1, isDynamicBatch_ ? 1 : inputShape_[0], results);
+    return results.empty() ? std::vector<Detection>() : std::move(results[0]);
 }
 
-// 预处理函数
-void YOLOWrapper::preprocess(cv::Mat& image, float*& blob, std::vector<int64_t>& inputTensorShape) {
-    cv::Mat resizedImage, floatImage;
-    // BGR -> RGB
-    cv::cvtColor(image, resizedImage, cv::COLOR_BGR2RGB);
-
-    // letterbox 缩放，保持长宽比
-    data_utils::letterbox(resizedImage, resizedImage, 
-                    cv::Size((int)this->inputShape_[2], (int)this->inputShape_[3]),  // 使用输入张量的尺寸
-                    cv::Scalar(114, 114, 114),  // 填充颜色
-                    false,  // isDynamicInputShape
-                    false,  // scaleFill
-                    true,   // scaleUp
-                    32);    // stride
-
-    // 更新输入张量形状
-    inputTensorShape[2] = resizedImage.rows;
-    inputTensorShape[3] = resizedImage.cols;
-
-    // 归一化到 [0,1]
-    resizedImage.convertTo(floatImage, CV_32FC3, 1.0 / 255.0);
-
-    // 分配内存
-    blob = new float[floatImage.cols * floatImage.rows * floatImage.channels()];
-    cv::Size floatImageSize{floatImage.cols, floatImage.rows};
-
-    // HWC -> CHW 转换
-    std::vector<cv::Mat> chw(floatImage.channels());
-    for (int i = 0; i < floatImage.channels(); ++i) {
-        chw[i] = cv::Mat(floatImageSize, CV_32FC1, blob + i * floatImageSize.width * floatImageSize.height);
+std::vector<std::vector<Detection>> YOLOWrapper::infer(const std::vector<cv::Mat>& frames) {
+    std::vector<std::vector<Detection>> results;
+    results.reserve(frames.size());
+    if (frames.empty()) return results;
+
+    if (isDynamicBatch_) {
+        // 动态 batch：一次送入全部图像
+        inferBatch(frames.data(), frames.size(), (int64_t)frames.size(), results);
+    } else {
+        // 固定 batch：按模型 batch 分组，最后一组不足时补齐
+        size_t modelBatch = (size_t)inputShape_[0];
+        for (size_t i = 0; i < frames.size(); i += modelBatch) {
+            size_t count = std::min(modelBatch, frames.size() - i);
+            inferBatch(frames.data() + i, count, (int64_t)modelBatch, results);
+        }
     }
-    cv::split(floatImage, chw);
+    return results;
 }
 
-// 后处理函数
-std::vector<Detection> YOLOWrapper::postprocess(
-    const cv::Size& resizedImageShape,
-    const cv::Size& originalImageShape,
-    std::vector<Ort::Value>& outputTensors
-) {
-    // 解析输出数据
-    std::vector<cv::Rect> boxes;
-    std::vector<float> confs;
-    std::vector<int> classIds;
-
-    float* boxOutput = outputTensors[0].GetTensorMutableData<float>();
-    cv::Mat output0 = cv::Mat(cv::Size((int)outputShape_[2], (int)outputShape_[1]), CV_32F, boxOutput).t();
-    float* output0ptr = (float*)output0.data;
-    int rows = (int)outputShape_[2];
-    int cols = (int)outputShape_[1];
-
-    for (int i = 0; i < rows; i++) {
-        std::vector<float> it(output0ptr + i * cols, output0ptr + (i + 1) * cols);
-        float confidence;
-        int classId;
-        
-        getBestClassInfo(it.begin(), confidence, classId);
-
-        if (confidence > config_.confThreshold) {
-            int centerX = (int)(it[0]);
-            int centerY = (int)(it[1]);
-            int width = (int)(it[2]);
-            int height = (int)(it[3]);
-            int left = centerX - width / 2;
-            int top = centerY - height / 2;
-            
-            boxes.emplace_back(left, top, width, height);
-            confs.emplace_back(confidence);
-            classIds.emplace_back(classId);
+void YOLOWrapper::inferBatch(const cv::Mat* frames, size_t count, int64_t batchSize,
+                             std::vector<std::vector<Detection>>& results) {
+    // 输入 H/W 在构造时已确定，只有 batch 会变化，后端仅在形状变化时重新分配和绑定
+    float* input = backend_->prepareInput({batchSize, 3, inputSize_.height, inputSize_.width});
+    size_t imageSize = 3 * (size_t)inputSize_.area();
+
+    // 直接写入后端的输入缓冲区；补齐的空位填 0，其输出会被丢弃
+    {
+        METRICS_SCOPE("yolo_preprocess");
+        std::fill(input + count * imageSize, input + batchSize * imageSize, 0.0f);
+        for (size_t i = 0; i < count; ++i) {
+            preprocess(frames[i], input + i * imageSize);
         }
     }
 
-    std::vector<int> indices;
-    cv::dnn::NMSBoxes(boxes, confs, config_.confThreshold, config_.iouThreshold, indices);
-
-    std::vector<Detection> results;
-    for (int idx : indices) {
-        Detection res;
-        res.box = cv::Rect(boxes[idx]);
-        res.confidence = confs[idx];
-        res.classId = classIds[idx];
+    // 输出形状 [B, 4+C, A]（v8）或 [B, A, 5+C]（v5），按图像拆分
+    std::vector<int64_t> outputShape;
+    const float* output = nullptr;
+    {
+        METRICS_SCOPE("yolo_run");
+        output = backend_->run(outputShape);
+    }
+    if (!output || outputShape.size() < 3) {
+        // 推理失败时这批图像按无检测结果处理
+        results.resize(results.size() + count);
+        return;
+    }
+    int64_t outputDim1 = outputShape[1];
+    int64_t outputDim2 = outputShape[2];
+
+    // 根据输出形状确定检测头布局与类别数；动态输入尺寸下 anchor 数会随之变化
+    METRICS_SCOPE("yolo_postprocess");
+    if (outputDim1 != resolvedDim1_ || outputDim2 != resolvedDim2_) {
+        decodeParams_ = yolo_decoder::resolveParams(config_.head, (int)outputDim1, (int)outputDim2,
+                                                    config_.confThreshold);
+        resolvedDim1_ = outputDim1;
+        resolvedDim2_ = outputDim2;
+    }
+    postprocess(frames, count, output, (size_t)(outputDim1 * outputDim2), results);
+}
 
-        data_utils::scaleCoords(res.box, resizedImageShape, originalImageShape);
+// 预处理函数：融合 BGR->RGB、letterbox、归一化和 HWC->CHW，一次写入输入缓冲区
+void YOLOWrapper::preprocess(const cv::Mat& image, float* blob) {
+    data_utils::letterboxToBlob(image, blob, inputSize_,
+                                cv::Scalar(114, 114, 114),  // 填充颜色
+                                resizeBuffer_);
+}
 
-        results.emplace_back(res);
+// 后处理函数：逐图解码候选框，批量 NMS，再映射回原图坐标
+void YOLOWrapper::postprocess(const cv::Mat* frames, size_t count,
+                              const float* output, size_t imageOutputSize,
+                              std::vector<std::vector<Detection>>& results) {
+    size_t first = results.size();
+    for (size_t i = 0; i < count; ++i) {
+        results.emplace_back();
+        yolo_decoder::decode(output + i * imageOutputSize, decodeParams_, results.back());
     }
 
-    return results;
-}
+    nms_utils::batchedNms(results, nmsOptions_, first);
 
-void YOLOWrapper::getBestClassInfo(std::vector<float>::iterator it, float& bestConf, int& bestClassId) {
-    // 跳过前4个坐标值
-    it += 4;
-    
-    // 找到最大置信度的类别
-    bestConf = 0;
-    bestClassId = 0;
-    for (int i = 0; i < 3; i++) {
-        if (it[i] > bestConf) {
-            bestConf = it[i];
-            bestClassId = i;
+    for (size_t i = 0; i < count; ++i) {
+        for (Detection& det : results[first + i]) {
+            data_utils::scaleCoords(det.box, inputSize_, frames[i].size());
         }
     }
 }
@@ -0,0 +1,293 @@
+// OCR 识别模型 INT8 / bf16 的标定数据生成与精度检查：
+//
+//   ./ocr_calibrate dump --cfg config.yaml --video a.mp4 [--video b.mp4 ...] --output ocr_calib/
+//                        [--samples 500] [--stride 15]
+//       从录像中按计时区域裁剪，保存区域图像（images/*.png）、与推理时相同前处理的输入张量
+//       （tensors/*.npy，供 tools/quantize_ocr.py 标定）和 FP32 模型的识别结果（labels.tsv，
+//       每行“文件名<TAB>文本”，可人工校对后作为标注）
+//
+//   ./ocr_calibrate evaluate --cfg config.yaml --data ocr_calib/ [--precision int8|bf16] [--report 路径]
+//       对 labels.tsv 中的区域图像分别以 FP32 和所选精度识别，输出与 FP32 的识别文本一致率、相对标注的
+//       准确率和每个区域的平均耗时；int8 时写出精度报告（默认 ocr_config.int8.model_dir + ".report.yaml"），
+//       运行时据此决定是否启用 INT8 模型
+#include <opencv2/opencv.hpp>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ocr.h"
+#include "quantization.h"
+#include "utils.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+struct Options {
+    string command;
+    string configPath = "../config.yaml";
+    vector<string> videos;
+    string output = "ocr_calib";
+    int samples = 500;
+    int stride = 15;
+    string data;
+    string precision = "int8";
+    string reportPath;
+};
+
+void usage(const char* program) {
+    cerr << "Usage: " << program << " dump --cfg config.yaml --video a.mp4 [--video b.mp4] --output dir"
+         << " [--samples 500] [--stride 15]" << endl
+         << "       " << program << " evaluate --cfg config.yaml --data dir [--precision int8|bf16]"
+         << " [--report path]" << endl;
+}
+
+bool makeDir(const string& path) {
+    return mkdir(path.c_str(), 0777) == 0 || errno == EEXIST;
+}
+
+// 单次送入的区域数，按 rec_batch_num 分批推理
+const size_t kChunk = 32;
+
+// 分块识别全部图像，返回每个区域的平均耗时（ms）；先完整跑一遍预热
+double recognizeAll(OCRWrapper& ocr, const vector<Mat>& images, vector<string>& texts) {
+    for (size_t i = 0; i < images.size(); i += kChunk) {
+        ocr.infer(vector<Mat>(images.begin() + i, images.begin() + min(images.size(), i + kChunk)));
+    }
+    texts.clear();
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < images.size(); i += kChunk) {
+        vector<string> chunk = ocr.infer(
+            vector<Mat>(images.begin() + i, images.begin() + min(images.size(), i + kChunk)));
+        texts.insert(texts.end(), chunk.begin(), chunk.end());
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return images.empty() ? 0 : ms / images.size();
+}
+
+int dump(const Options& options, const OCRWrapper::Config& ocrConfig, const vector<Rect>& rois) {
+    if (!makeDir(options.output) || !makeDir(options.output + "/images") || !makeDir(options.output + "/tensors")) {
+        cerr << "Error: Cannot create " << options.output << endl;
+        return -1;
+    }
+    ofstream labels(options.output + "/labels.tsv");
+    if (!labels) {
+        cerr << "Error: Cannot write " << options.output << "/labels.tsv" << endl;
+        return -1;
+    }
+    OCRWrapper ocr(ocrConfig);
+
+    int written = 0;
+    char name[32];
+    int total = sampleVideos(options.videos, options.samples, options.stride,
+                             [&](const Mat& frame, const string&, int, int budget) {
+        vector<Mat> crops = cropROIs(frame, rois);
+        vector<string> texts = ocr.infer(crops);
+        int taken = 0;
+        for (size_t i = 0; i < crops.size() && taken < budget; ++i) {
+            int width = 0;
+            vector<float> blob = ocr.preprocessSingle(crops[i], width);
+            snprintf(name, sizeof(name), "%06d", written);
+            string stem = name;
+            if (!imwrite(options.output + "/images/" + stem + ".png", crops[i]) ||
+                !quantization::writeNpy(options.output + "/tensors/" + stem + ".npy", blob.data(),
+                                        {1, 3, ocrConfig.recImgH, width})) {
+                cerr << "Error: Cannot write sample " << stem << endl;
+                return -1;
+            }
+            labels << stem << ".png\t" << (i < texts.size() ? texts[i] : "") << "\n";
+            taken++;
+            written++;
+        }
+        return taken;
+    });
+    if (total < 0) return -1;
+    cout << "标定数据: " << written << " 个区域 -> " << options.output
+         << "（labels.tsv 为 FP32 识别结果，校对后可作为标注）" << endl;
+    return written > 0 ? 0 : -1;
+}
+
+int evaluate(const Options& options, const OCRWrapper::Config& ocrConfig) {
+    vector<string> files, labels;
+    vector<Mat> images;
+    ifstream labelFile(options.data + "/labels.tsv");
+    string line;
+    while (getline(labelFile, line)) {
+        size_t tab = line.find('\t');
+        string file = line.substr(0, tab);
+        Mat image = imread(options.data + "/images/" + file);
+        if (file.empty() || image.empty()) continue;
+        files.push_back(file);
+        labels.push_back(tab == string::npos ? "" : line.substr(tab + 1));
+        images.push_back(image);
+    }
+    if (images.empty()) {
+        cerr << "Error: No samples in " << options.data << "/labels.tsv" << endl;
+        return -1;
+    }
+
+    // 关闭结果缓存，每个区域都实际推理
+    OCRWrapper::Config reference = ocrConfig;
+    reference.cacheEnable = false;
+    reference.precision = "fp32";
+    OCRWrapper::Config candidate = reference;
+    candidate.precision = options.precision;
+    if (options.precision == "int8") {
+        if (ocrConfig.int8ModelDir.empty()) {
+            cerr << "Error: ocr_config.int8.model_dir 未配置" << endl;
+            return -1;
+        }
+        // 直接加载量化模型，不经过精度报告检查
+        candidate.modelPath = ocrConfig.int8ModelDir;
+        candidate.int8ModelDir.clear();
+    }
+
+    vector<string> fp32Texts, texts;
+    double fp32Ms, candidateMs;
+    {
+        OCRWrapper ocr(reference);
+        if (!ocr.loaded()) {
+            cerr << "Error: FP32 模型加载失败: " << reference.modelPath << endl;
+            return -1;
+        }
+        fp32Ms = recognizeAll(ocr, images, fp32Texts);
+    }
+    {
+        OCRWrapper ocr(candidate);
+        if (!ocr.loaded()) {
+            cerr << "Error: " << options.precision << " 模型加载失败: " << candidate.modelPath << endl;
+            return -1;
+        }
+        // 后端回退到其他精度（如 CPU 不支持 bf16）时对比没有意义
+        if (ocr.precision() != options.precision) {
+            cerr << "Error: 请求的精度 " << options.precision << " 未生效，实际为 " << ocr.precision() << endl;
+            return -1;
+        }
+        candidateMs = recognizeAll(ocr, images, texts);
+    }
+    // FP32 全部识别为空时一致率恒为 1，不能作为启用 INT8 的依据，不写报告
+    if (all_of(fp32Texts.begin(), fp32Texts.end(), [](const string& text) { return text.empty(); })) {
+        cerr << "Error: FP32 模型对全部 " << images.size() << " 个区域均未识别出文本，无法评估精度"
+             << "（检查计时区域配置和模型）" << endl;
+        return -1;
+    }
+
+    size_t agree = 0, fp32Correct = 0, correct = 0;
+    vector<size_t> mismatches;
+    for (size_t i = 0; i < images.size(); ++i) {
+        agree += texts[i] == fp32Texts[i];
+        fp32Correct += fp32Texts[i] == labels[i];
+        correct += texts[i] == labels[i];
+        if (texts[i] != labels[i]) mismatches.push_back(i);
+    }
+    double n = (double)images.size();
+
+    quantization::Report report;
+    report.fp32Model = ocrConfig.modelPath;
+    report.int8Model = candidate.modelPath;
+    report.frames = (int)images.size();
+    report.agreement = agree / n;
+    report.labelAccuracy = correct / n;
+    report.fp32LatencyMs = fp32Ms;
+    report.int8LatencyMs = candidateMs;
+
+    cout << "---------- OCR " << options.precision << " 精度检查（" << images.size() << " 个区域） ----------" << endl;
+    cout << fixed << setprecision(4)
+         << "与 FP32 一致率: " << report.agreement << endl
+         << "相对标注准确率: FP32 " << fp32Correct / n << ", " << options.precision << " " << report.labelAccuracy << endl;
+    for (size_t k = 0; k < mismatches.size() && k < 10; ++k) {
+        size_t i = mismatches[k];
+        cout << "  " << files[i] << "  标注 \"" << labels[i] << "\"  FP32 \"" << fp32Texts[i]
+             << "\"  " << options.precision << " \"" << texts[i] << "\"" << endl;
+    }
+    cout << setprecision(3) << "每个区域耗时: FP32 " << fp32Ms << " ms, " << options.precision << " "
+         << candidateMs << " ms" << endl;
+
+    string reportPath = options.reportPath;
+    if (reportPath.empty() && options.precision == "int8") {
+        reportPath = quantization::reportPathFor(ocrConfig.int8ModelDir, ocrConfig.int8ReportPath);
+    }
+    if (!reportPath.empty()) {
+        if (!quantization::writeReport(reportPath, report)) {
+            cerr << "Error: Cannot write report " << reportPath << endl;
+            return -1;
+        }
+        cout << "精度报告: " << reportPath << endl;
+    }
+
+    bool accepted = report.agreement >= ocrConfig.int8MinAgreement;
+    cout << (accepted ? "一致率达到阈值 " : "一致率低于阈值 ") << ocrConfig.int8MinAgreement << endl;
+    return accepted ? 0 : 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (argc < 2) {
+        usage(argv[0]);
+        return -1;
+    }
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--cfg" && i + 1 < argc) options.configPath = argv[++i];
+        else if (arg == "--video" && i + 1 < argc) options.videos.push_back(argv[++i]);
+        else if (arg == "--output" && i + 1 < argc) options.output = argv[++i];
+        else if (arg == "--samples" && i + 1 < argc) options.samples = atoi(argv[++i]);
+        else if (arg == "--stride" && i + 1 < argc) options.stride = max(1, atoi(argv[++i]));
+        else if (arg == "--data" && i + 1 < argc) options.data = argv[++i];
+        else if (arg == "--precision" && i + 1 < argc) options.precision = argv[++i];
+        else if (arg == "--report" && i + 1 < argc) options.reportPath = argv[++i];
+        else {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    string videoSource;
+    YOLOWrapper::Config yoloConfig;
+    OCRWrapper::Config ocrConfig;
+    bool enableVideoOutput;
+    string videoOutputPath;
+    string videoCodec;
+    int videoFps;
+    FramePipeline::Config pipelineConfig;
+    if (!loadConfig(options.configPath, videoSource, yoloConfig, ocrConfig,
+                    enableVideoOutput, videoOutputPath, videoCodec, videoFps, pipelineConfig)) {
+        return -1;
+    }
+
+    if (options.command == "dump") {
+        if (options.videos.empty()) {
+            options.videos.push_back(pipelineConfig.streams.empty() ? videoSource
+                                                                    : pipelineConfig.streams.front().source);
+        }
+        // 与流水线一致：对计时区域识别，多路模式下取第一路的区域
+        vector<RegionOfInterest> timerROIs = pipelineConfig.timerROIs;
+        if (!pipelineConfig.streams.empty() && !pipelineConfig.streams.front().timerROIs.empty()) {
+            timerROIs = pipelineConfig.streams.front().timerROIs;
+        }
+        vector<Rect> rois;
+        for (const RegionOfInterest& roi : timerROIs) rois.push_back(roi.rect);
+
+        // 以 FP32 模型生成标定数据和参考结果
+        OCRWrapper::Config fp32Config = ocrConfig;
+        fp32Config.precision = "fp32";
+        fp32Config.cacheEnable = false;
+        return dump(options, fp32Config, rois);
+    }
+    if (options.command == "evaluate" && !options.data.empty() &&
+        (options.precision == "int8" || options.precision == "bf16")) {
+        return evaluate(options, ocrConfig);
+    }
+    usage(argv[0]);
+    return -1;
+}
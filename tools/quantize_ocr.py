@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""OCR 识别模型（Paddle Inference 格式）训练后 INT8 量化。
+
+读取 ocr_calibrate dump 生成的标定张量（与推理时相同的前处理），用 Paddle 的
+PostTrainingQuantization 生成带 quantize_linear / dequantize_linear 算子的量化模型；
+C++ 端 precision: int8 时以 EnableMkldnnInt8 加载，由 MKLDNN int8 pass 融合为整数内核。
+
+    pip install paddlepaddle numpy
+    python3 tools/quantize_ocr.py --model-dir ch_PP-OCRv3_rec_infer --calib ocr_calib/ \\
+        --output ch_PP-OCRv3_rec_int8
+
+量化后用 ocr_calibrate evaluate --precision int8 与 FP32 对比并生成精度报告。
+"""
+import argparse
+import glob
+import os
+
+import numpy as np
+import paddle
+from paddle.static.quantization import PostTrainingQuantization
+
+
+def main():
+    parser = argparse.ArgumentParser(description="OCR 识别模型训练后 INT8 量化")
+    parser.add_argument("--model-dir", required=True, help="FP32 模型目录（inference.pdmodel / inference.pdiparams）")
+    parser.add_argument("--calib", required=True, help="ocr_calibrate dump 的输出目录")
+    parser.add_argument("--output", required=True, help="量化模型输出目录")
+    parser.add_argument("--algo", default="hist", choices=["abs_max", "avg", "hist", "KL", "mse"],
+                        help="激活值范围的标定方法")
+    parser.add_argument("--hist-percent", type=float, default=0.9999, help="hist 方法的百分位")
+    parser.add_argument("--max-samples", type=int, default=0, help="最多使用的标定样本数，0 表示全部")
+    args = parser.parse_args()
+
+    files = sorted(glob.glob(os.path.join(args.calib, "tensors", "*.npy")))
+    if args.max_samples > 0:
+        files = files[:args.max_samples]
+    if not files:
+        raise SystemExit("no calibration tensors in " + os.path.join(args.calib, "tensors"))
+
+    # 各区域的输入宽度可能不同（分桶），逐个样本作为一个 batch 送入
+    def batch_generator():
+        for path in files:
+            yield [np.load(path).astype(np.float32)]
+
+    paddle.enable_static()
+    executor = paddle.static.Executor(paddle.CPUPlace())
+    ptq = PostTrainingQuantization(
+        executor=executor,
+        model_dir=args.model_dir,
+        model_filename="inference.pdmodel",
+        params_filename="inference.pdiparams",
+        batch_generator=batch_generator,
+        batch_nums=len(files),
+        algo=args.algo,
+        hist_percent=args.hist_percent,
+        quantizable_op_type=["conv2d", "depthwise_conv2d", "matmul", "matmul_v2", "mul"],
+        weight_quantize_type="channel_wise_abs_max",
+        onnx_format=True,
+        is_full_quantize=False)
+    ptq.quantize()
+    ptq.save_quantized_model(args.output,
+                             model_filename="inference.pdmodel",
+                             params_filename="inference.pdiparams")
+    print("calibration samples: %d, saved %s" % (len(files), args.output))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""YOLO ONNX 模型静态 INT8 量化。
+
+读取 yolo_calibrate dump 生成的标定张量（与推理时相同的前处理），用 ONNX Runtime 的
+quantize_static 生成 QDQ 格式的 INT8 模型；C++ 端的 ONNX Runtime 在 ORT_ENABLE_ALL 下
+会把 QDQ 节点融合为整数算子，在支持 VNNI / AMX 的 CPU 上走 INT8 内核。
+
+    pip install onnx onnxruntime numpy
+    python3 tools/quantize_yolo.py --model best.onnx --calib calib/ --output best.int8.onnx
+
+量化后用 yolo_calibrate evaluate 在另一段录像上与 FP32 对比并生成精度报告。
+"""
+import argparse
+import glob
+import os
+
+import numpy as np
+import onnx
+from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod, QuantFormat,
+                                      QuantType, quantize_static)
+
+
+class NpyDataReader(CalibrationDataReader):
+    """逐个读取 .npy 标定张量，作为模型唯一输入"""
+
+    def __init__(self, files, input_name):
+        self.files = files
+        self.input_name = input_name
+        self.index = 0
+
+    def get_next(self):
+        if self.index >= len(self.files):
+            return None
+        data = np.load(self.files[self.index]).astype(np.float32)
+        self.index += 1
+        return {self.input_name: data}
+
+    def rewind(self):
+        self.index = 0
+
+
+def head_nodes(model):
+    """从输出往回直到遇到 Conv 为止的解码节点（框坐标与类别概率拼接、DFL 等）。
+
+    检测头输出同时包含像素坐标（0~640）和概率（0~1），共用一组量化参数会严重损失精度，
+    这部分计算量很小，保留为浮点。
+    """
+    producers = {}
+    for node in model.graph.node:
+        for output in node.output:
+            producers[output] = node
+    excluded = []
+    seen = set()
+    pending = [output.name for output in model.graph.output]
+    while pending:
+        node = producers.get(pending.pop())
+        if node is None or node.name in seen or node.op_type == "Conv":
+            continue
+        seen.add(node.name)
+        excluded.append(node.name)
+        pending.extend(node.input)
+    return excluded
+
+
+def main():
+    parser = argparse.ArgumentParser(description="YOLO ONNX 静态 INT8 量化")
+    parser.add_argument("--model", required=True, help="FP32 ONNX 模型")
+    parser.add_argument("--calib", required=True, help="yolo_calibrate dump 的输出目录")
+    parser.add_argument("--output", required=True, help="INT8 模型输出路径")
+    parser.add_argument("--method", default="minmax", choices=["minmax", "entropy", "percentile"],
+                        help="激活值范围的标定方法")
+    parser.add_argument("--max-samples", type=int, default=0, help="最多使用的标定样本数，0 表示全部")
+    parser.add_argument("--per-tensor", action="store_true", help="权重按张量量化（默认按通道）")
+    parser.add_argument("--reduce-range", action="store_true",
+                        help="权重使用 7 位范围，在不支持 VNNI 的 AVX2 CPU 上避免 U8S8 饱和")
+    parser.add_argument("--quantize-head", action="store_true", help="检测头解码部分也量化")
+    args = parser.parse_args()
+
+    files = sorted(glob.glob(os.path.join(args.calib, "*.npy")))
+    if args.max_samples > 0:
+        files = files[:args.max_samples]
+    if not files:
+        raise SystemExit("no calibration tensors in " + args.calib)
+
+    model = onnx.load(args.model)
+    initializers = {init.name for init in model.graph.initializer}
+    inputs = [i.name for i in model.graph.input if i.name not in initializers]
+    if len(inputs) != 1:
+        raise SystemExit("expected a single model input, got %s" % inputs)
+
+    excluded = [] if args.quantize_head else head_nodes(model)
+    print("calibration samples: %d, float head nodes: %d" % (len(files), len(excluded)))
+
+    methods = {
+        "minmax": CalibrationMethod.MinMax,
+        "entropy": CalibrationMethod.Entropy,
+        "percentile": CalibrationMethod.Percentile,
+    }
+    quantize_static(args.model, args.output, NpyDataReader(files, inputs[0]),
+                    quant_format=QuantFormat.QDQ,
+                    activation_type=QuantType.QUInt8,
+                    weight_type=QuantType.QInt8,
+                    per_channel=not args.per_tensor,
+                    reduce_range=args.reduce_range,
+                    nodes_to_exclude=excluded,
+                    calibrate_method=methods[args.method])
+    print("saved", args.output)
+
+
+if __name__ == "__main__":
+    main()
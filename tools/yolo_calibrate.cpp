@@ -0,0 +1,241 @@
+// YOLO INT8 量化的标定数据生成与精度对比：
+//
+//   ./yolo_calibrate dump --cfg config.yaml --video a.mp4 [--video b.mp4 ...] --output calib/
+//                         [--samples 300] [--stride 15]
+//       从录像中均匀抽帧，按配置的信号灯区域裁剪，用 YOLOWrapper::preprocess 生成与推理时完全一致的
+//       [1,3,H,W] 输入张量（.npy），交给 tools/quantize_yolo.py 做静态量化
+//
+//   ./yolo_calibrate evaluate --cfg config.yaml --int8 best.int8.onnx --video val.mp4
+//                             [--frames 300] [--skip 0] [--report 路径]
+//       在相同的帧上分别运行 FP32（yolo_config.model_path）和 INT8 模型，输出检测一致率、召回、
+//       精确率、IoU、置信度偏差和延迟，写出精度报告；运行时据此报告决定是否启用 INT8 模型
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "yolo_wrapper.h"
+#include "backend_compare.h"
+#include "quantization.h"
+#include "utils.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+struct Options {
+    string command;
+    string configPath = "../config.yaml";
+    vector<string> videos;
+    string output = "calib";
+    int samples = 300;
+    int stride = 15;
+    string int8Path;
+    int frames = 300;
+    int skip = 0;
+    string reportPath;
+};
+
+void usage(const char* program) {
+    cerr << "Usage: " << program << " dump --cfg config.yaml --video a.mp4 [--video b.mp4] --output dir"
+         << " [--samples 300] [--stride 15]" << endl
+         << "       " << program << " evaluate --cfg config.yaml --int8 model.onnx --video val.mp4"
+         << " [--frames 300] [--skip 0] [--report path]" << endl;
+}
+
+int dump(const Options& options, const YOLOWrapper::Config& yoloConfig, const vector<Rect>& rois) {
+    YOLOWrapper yolo(yoloConfig);
+    Size inputSize = yolo.inputSize();
+    vector<float> blob(3 * (size_t)inputSize.area());
+    vector<int> shape = {1, 3, inputSize.height, inputSize.width};
+
+    ofstream manifest(options.output + "/manifest.txt");
+    if (!manifest) {
+        cerr << "Error: Cannot write to " << options.output << " (目录需已存在)" << endl;
+        return -1;
+    }
+
+    int written = 0;
+    char name[32];
+    int total = sampleVideos(options.videos, options.samples, options.stride,
+                             [&](const Mat& frame, const string& video, int index, int budget) {
+        int taken = 0;
+        for (const Mat& crop : cropROIs(frame, rois)) {
+            if (taken >= budget) break;
+            yolo.preprocess(crop, blob.data());
+            snprintf(name, sizeof(name), "%06d.npy", written);
+            if (!quantization::writeNpy(options.output + "/" + name, blob.data(), shape)) {
+                cerr << "Error: Cannot write " << name << endl;
+                return -1;
+            }
+            manifest << name << "\t" << video << "\t" << index << "\n";
+            taken++;
+            written++;
+        }
+        return taken;
+    });
+    if (total < 0) return -1;
+    cout << "标定数据: " << written << " 个 [1,3," << inputSize.height << "," << inputSize.width
+         << "] 张量 -> " << options.output << endl;
+    return written > 0 ? 0 : -1;
+}
+
+int evaluate(const Options& options, YOLOWrapper::Config yoloConfig, const vector<Rect>& rois) {
+    YOLOWrapper fp32(yoloConfig);
+    YOLOWrapper::Config int8Config = yoloConfig;
+    int8Config.modelPath = options.int8Path;
+    YOLOWrapper int8(int8Config);
+    if (fp32.inputSize() != int8.inputSize()) {
+        cerr << "Error: FP32 与 INT8 模型输入尺寸不一致" << endl;
+        return -1;
+    }
+
+    const int warmup = 5;  // 前几帧只参与精度对比，不计入延迟
+    backend_compare::DetectionDelta delta;
+    double fp32Ms = 0, int8Ms = 0;
+    int frames = 0, timed = 0;
+    for (const string& video : options.videos) {
+        VideoCapture cap(video);
+        if (!cap.isOpened()) {
+            cerr << "Error: Cannot open the video " << video << endl;
+            return -1;
+        }
+        Mat frame;
+        for (int index = 0; frames < options.frames && cap.read(frame); ++index) {
+            if (index < options.skip) continue;
+            vector<Mat> crops = cropROIs(frame, rois);
+
+            auto start = chrono::steady_clock::now();
+            vector<vector<Detection>> reference = fp32.infer(crops);
+            auto mid = chrono::steady_clock::now();
+            vector<vector<Detection>> candidate = int8.infer(crops);
+            auto end = chrono::steady_clock::now();
+
+            for (size_t i = 0; i < reference.size() && i < candidate.size(); ++i) {
+                backend_compare::compareDetections(reference[i], candidate[i], delta);
+            }
+            if (frames++ >= warmup) {
+                fp32Ms += chrono::duration<double, milli>(mid - start).count();
+                int8Ms += chrono::duration<double, milli>(end - mid).count();
+                timed++;
+            }
+        }
+    }
+    if (frames == 0) {
+        cerr << "Error: No frames evaluated" << endl;
+        return -1;
+    }
+    // FP32 没有检出任何框时一致率恒为 1，不能作为启用 INT8 的依据，不写报告
+    if (delta.referenceBoxes == 0) {
+        cerr << "Error: FP32 模型在 " << frames << " 帧中没有检出任何目标，无法评估 INT8 精度"
+             << "（检查视频与信号灯区域配置）" << endl;
+        return -1;
+    }
+
+    quantization::Report report;
+    report.fp32Model = yoloConfig.modelPath;
+    report.int8Model = options.int8Path;
+    report.frames = frames;
+    report.agreement = delta.agreement();
+    report.recall = delta.recall();
+    report.precision = delta.precision();
+    report.meanIou = delta.meanIou();
+    report.meanScoreDelta = delta.meanScoreDelta();
+    report.fp32LatencyMs = timed ? fp32Ms / timed : 0;
+    report.int8LatencyMs = timed ? int8Ms / timed : 0;
+
+    cout << "---------- INT8 精度对比（" << frames << " 帧，基准为 FP32） ----------" << endl;
+    cout << fixed << setprecision(4)
+         << "FP32 框数: " << delta.referenceBoxes << "  INT8 框数: " << delta.candidateBoxes
+         << "  匹配: " << delta.matched << endl
+         << "一致率: " << report.agreement << "  召回: " << report.recall
+         << "  精确率: " << report.precision << endl
+         << "平均 IoU: " << report.meanIou << "  平均置信度偏差: " << report.meanScoreDelta << endl;
+    for (size_t c = 0; c < delta.classReference.size(); ++c) {
+        if (delta.classReference[c] == 0) continue;
+        cout << "  类别 " << c << " 召回: " << (double)delta.classMatched[c] / delta.classReference[c]
+             << " (" << delta.classMatched[c] << "/" << delta.classReference[c] << ")" << endl;
+    }
+    cout << setprecision(2) << "延迟（含前后处理）: FP32 " << report.fp32LatencyMs << " ms, INT8 "
+         << report.int8LatencyMs << " ms" << endl;
+
+    string reportPath = quantization::reportPathFor(options.int8Path, options.reportPath);
+    if (!quantization::writeReport(reportPath, report)) {
+        cerr << "Error: Cannot write report " << reportPath << endl;
+        return -1;
+    }
+    cout << "精度报告: " << reportPath << endl;
+
+    bool accepted = report.agreement >= yoloConfig.int8MinAgreement;
+    cout << (accepted ? "一致率达到阈值 " : "一致率低于阈值 ") << yoloConfig.int8MinAgreement
+         << (accepted ? "，运行时将使用 INT8 模型" : "，运行时将回退到 FP32 模型") << endl;
+    return accepted ? 0 : 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (argc < 2) {
+        usage(argv[0]);
+        return -1;
+    }
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--cfg" && i + 1 < argc) options.configPath = argv[++i];
+        else if (arg == "--video" && i + 1 < argc) options.videos.push_back(argv[++i]);
+        else if (arg == "--output" && i + 1 < argc) options.output = argv[++i];
+        else if (arg == "--samples" && i + 1 < argc) options.samples = atoi(argv[++i]);
+        else if (arg == "--stride" && i + 1 < argc) options.stride = max(1, atoi(argv[++i]));
+        else if (arg == "--int8" && i + 1 < argc) options.int8Path = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc) options.frames = atoi(argv[++i]);
+        else if (arg == "--skip" && i + 1 < argc) options.skip = atoi(argv[++i]);
+        else if (arg == "--report" && i + 1 < argc) options.reportPath = argv[++i];
+        else {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    string videoSource;
+    YOLOWrapper::Config yoloConfig;
+    OCRWrapper::Config ocrConfig;
+    bool enableVideoOutput;
+    string videoOutputPath;
+    string videoCodec;
+    int videoFps;
+    FramePipeline::Config pipelineConfig;
+    if (!loadConfig(options.configPath, videoSource, yoloConfig, ocrConfig,
+                    enableVideoOutput, videoOutputPath, videoCodec, videoFps, pipelineConfig)) {
+        return -1;
+    }
+    // 始终以 FP32 模型为基准，不经过 INT8 选择
+    yoloConfig.int8ModelPath.clear();
+    if (options.videos.empty()) {
+        options.videos.push_back(pipelineConfig.streams.empty() ? videoSource
+                                                                : pipelineConfig.streams.front().source);
+    }
+
+    // 与流水线一致：对信号灯区域检测，多路模式下取第一路的区域
+    vector<RegionOfInterest> lightROIs = pipelineConfig.lightROIs;
+    if (!pipelineConfig.streams.empty() && !pipelineConfig.streams.front().lightROIs.empty()) {
+        lightROIs = pipelineConfig.streams.front().lightROIs;
+    }
+    vector<Rect> rois;
+    for (const RegionOfInterest& roi : lightROIs) rois.push_back(roi.rect);
+
+    if (options.command == "dump") {
+        return dump(options, yoloConfig, rois);
+    }
+    if (options.command == "evaluate" && !options.int8Path.empty()) {
+        return evaluate(options, yoloConfig, rois);
+    }
+    usage(argv[0]);
+    return -1;
+}